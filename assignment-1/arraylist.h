@@ -2,22 +2,60 @@
 
 #include <algorithm>
 #include <concepts>
+#include <cstring>
+#include <iterator>
+#include <memory>
+#include <ranges>
+#include <stdexcept>
+#include <type_traits>
 
 #include "list.h"
+#include "serialization.h"
+#include "simd_search.h"
 
 namespace cse204 {
-template <typename T> class ArrayList : public List<T> {
+
+/* Uninitialised storage for N elements inside an object, empty when N is 0 */
+template <class T, std::size_t N> struct InlineBuffer {
+  alignas(T) unsigned char bytes[N * sizeof(T)];
+
+  inline T *data() { return reinterpret_cast<T *>(bytes); }
+};
+
+template <class T> struct InlineBuffer<T, 0> {
+  inline T *data() { return nullptr; }
+};
+
+/* InlineCapacity elements are stored inside the list object itself, the data
+ * array is only allocated once the list grows beyond them. */
+template <class T, class Allocator = std::allocator<T>,
+          std::size_t InlineCapacity = 0>
+class ArrayList final : public List<T> {
 
   using typename List<T>::size_t;
   using List<T>::npos;
+  using allocator_traits = std::allocator_traits<Allocator>;
 
+public:
   static constexpr size_t k_default_chunk_size = 8;
+  /* Capacity is multiplied by this factor on expansion. A factor of 1 or less
+   * selects the chunked policy, where capacity grows by chunk_size only. */
+  static constexpr double k_default_growth_factor = 2.0;
+  static constexpr size_t k_inline_capacity = InlineCapacity;
+
+private:
+  Allocator m_allocator;
+  [[no_unique_address]] InlineBuffer<T, InlineCapacity> m_inline;
 
   size_t m_chunk_size;
+  double m_growth_factor;
   size_t m_capacity;
   size_t m_length;
   size_t m_pos;
 
+  /* Only the first m_length elements are constructed, rest of the capacity is
+   * uninitialised memory. Points to m_inline while the elements fit in it, in
+   * which case the capacity is exactly the inline capacity. */
   T *m_data;
 
 /* check validity of state */
@@ -32,65 +70,85 @@ template <typename T> class ArrayList : public List<T> {
 
 public:
   /* creates empty list */
-  ArrayList(size_t chunk_size = k_default_chunk_size)
-      : m_chunk_size(k_default_chunk_size), m_capacity(m_chunk_size),
-        m_length(0), m_pos(0), m_data(new T[m_capacity]) {
-          CHECK_STATE();
-        }
+  ArrayList(size_t chunk_size = k_default_chunk_size,
+            double growth_factor = k_default_growth_factor)
+      : m_chunk_size(chunk_size), m_growth_factor(growth_factor),
+        m_capacity(initial_capacity(m_chunk_size)), m_length(0), m_pos(0),
+        m_data(allocate(m_capacity)) {
+    CHECK_STATE();
+  }
 
   /* Create list from initializer list */
   ArrayList(std::initializer_list<T> items,
-            size_t chunk_size = k_default_chunk_size)
-      : m_chunk_size(chunk_size), m_capacity(m_chunk_size),
-        m_length(items.size()), m_pos(0) {
+            size_t chunk_size = k_default_chunk_size,
+            double growth_factor = k_default_growth_factor)
+      : m_chunk_size(chunk_size), m_growth_factor(growth_factor),
+        m_capacity(initial_capacity(m_chunk_size)), m_length(items.size()),
+        m_pos(0) {
     fit_and_allocate();
-    std::copy(items.begin(), items.end(), m_data);
+    std::uninitialized_copy(items.begin(), items.end(), m_data);
     CHECK_STATE();
   }
   /* Creates list with data from static array */
   template <size_t N>
-  ArrayList(T const (&items)[N], size_t chunk_size = k_default_chunk_size)
-      : m_chunk_size(chunk_size), m_capacity(m_chunk_size), m_length(N),
-        m_pos(0) {
+  ArrayList(T const (&items)[N], size_t chunk_size = k_default_chunk_size,
+            double growth_factor = k_default_growth_factor)
+      : m_chunk_size(chunk_size), m_growth_factor(growth_factor),
+        m_capacity(initial_capacity(m_chunk_size)), m_length(N), m_pos(0) {
     fit_and_allocate();
-    std::copy(items, items + N, m_data);
+    std::uninitialized_copy(items, items + N, m_data);
     CHECK_STATE();
   }
 
   /* creates list with pointer data */
   ArrayList(size_t num_items, T const *items,
-            size_t chunk_size = k_default_chunk_size)
-      : m_chunk_size(chunk_size), m_capacity(m_chunk_size), m_length(num_items),
+            size_t chunk_size = k_default_chunk_size,
+            double growth_factor = k_default_growth_factor)
+      : m_chunk_size(chunk_size), m_growth_factor(growth_factor),
+        m_capacity(initial_capacity(m_chunk_size)), m_length(num_items),
         m_pos(0) {
     fit_and_allocate();
-    std::copy(items, items + num_items, m_data);
+    std::uninitialized_copy(items, items + num_items, m_data);
     CHECK_STATE();
   }
 
   /* copy constructor: copies elements from other list */
-  ArrayList(const ArrayList<T> &other)
-      : m_chunk_size(other.m_chunk_size), m_capacity(other.m_capacity),
-        m_length(other.m_length), m_pos(other.m_pos),
-        m_data(new T[m_capacity]) {
-    std::copy(other.m_data, other.m_data + other.m_length, m_data);
+  ArrayList(const ArrayList &other) requires std::copyable<T>
+      : m_chunk_size(other.m_chunk_size),
+        m_growth_factor(other.m_growth_factor),
+        m_capacity(other.m_capacity),
+        m_length(other.m_length),
+        m_pos(other.m_pos),
+        m_data(allocate(m_capacity)) {
+    std::uninitialized_copy(other.m_data, other.m_data + other.m_length,
+                            m_data);
     CHECK_STATE();
   }
 
-  /* move constructor: steals elements from other list */
-  ArrayList(ArrayList<T> &&other)
-      : m_chunk_size(other.m_chunk_size), m_capacity(other.m_capacity),
+  /* move constructor: steals elements from other list, inline elements are
+   * moved one by one */
+  ArrayList(ArrayList &&other)
+      : m_allocator(std::move(other.m_allocator)),
+        m_chunk_size(other.m_chunk_size),
+        m_growth_factor(other.m_growth_factor), m_capacity(other.m_capacity),
         m_length(other.m_length), m_pos(other.m_pos), m_data(other.m_data) {
+    if (other.is_inline()) {
+      m_data = m_inline.data();
+      std::uninitialized_move(other.m_data, other.m_data + other.m_length,
+                              m_data);
+      other.destroy_elements();
+    }
     /* Will resize to default capacity if inserted again */
     other.m_chunk_size = k_default_chunk_size;
-    other.m_capacity = 0;
+    other.m_capacity = initial_capacity(0);
     other.m_length = 0;
     other.m_pos = 0;
-    other.m_data = nullptr;
+    other.m_data = other.m_inline.data();
     CHECK_STATE();
   }
 
   /* copy assignment: copies elements from other list */
-  ArrayList<T> &operator=(const ArrayList<T> &other) {
+  ArrayList &operator=(const ArrayList &other) requires std::copyable<T> {
     if (this == &other) {
       return *this;
     }
@@ -98,24 +156,46 @@ public:
     m_length = other.m_length;
     m_pos = other.m_pos;
     if (m_capacity < other.m_length) {
-      delete[] m_data;
+      deallocate();
       fit_and_allocate();
     }
-    std::copy(other.m_data, other.m_data + other.m_length, m_data);
+    std::uninitialized_copy(other.m_data, other.m_data + other.m_length,
+                            m_data);
 
     CHECK_STATE();
     return *this;
   }
 
   /* move assignment: steals elements from other list */
-  ArrayList<T> &operator=(ArrayList<T> &&other) {
+  ArrayList &operator=(ArrayList &&other) {
+    if (this == &other) {
+      return *this;
+    }
     // exchange data and capacity, but setting other empty
     destroy_elements();
     m_length = other.m_length;
     m_pos = other.m_pos;
     std::swap(m_chunk_size, other.m_chunk_size);
-    std::swap(m_capacity, other.m_capacity);
-    std::swap(m_data, other.m_data);
+    std::swap(m_growth_factor, other.m_growth_factor);
+    if (other.is_inline()) {
+      // always fits, capacity is never below the inline capacity
+      std::uninitialized_move(other.m_data, other.m_data + other.m_length,
+                              m_data);
+      other.destroy_elements();
+    } else if (is_inline()) {
+      // other takes over the empty inline storage of its own, the heap array
+      // comes along with the allocator that owns it
+      std::swap(m_allocator, other.m_allocator);
+      m_capacity = other.m_capacity;
+      m_data = other.m_data;
+      other.m_capacity = InlineCapacity;
+      other.m_data = other.m_inline.data();
+    } else {
+      // swap the heap arrays along with the allocators that own them
+      std::swap(m_allocator, other.m_allocator);
+      std::swap(m_capacity, other.m_capacity);
+      std::swap(m_data, other.m_data);
+    }
     other.m_pos = other.m_length = 0;
 
     CHECK_STATE();
@@ -123,43 +203,148 @@ public:
   }
 
   /* destructor */
-  ~ArrayList() { delete[] m_data; }
+  ~ArrayList() {
+    destroy_elements();
+    deallocate();
+  }
 
 private:
   /* helper methods */
 
-  /* Increase capacity by chunk_size until it accomodates length, then allocate
-   * to that capacity */
-  void fit_and_allocate() {
-    while (m_capacity < m_length) {
-      m_capacity += m_chunk_size;
+  /* Capacity of a new list, lists with inline storage start out using it */
+  static constexpr size_t initial_capacity(size_t chunk_size) {
+    return InlineCapacity > 0 ? InlineCapacity : chunk_size;
+  }
+
+  /* Whether the elements are stored inside the list object */
+  inline bool is_inline() {
+    return InlineCapacity > 0 && m_data == m_inline.data();
+  }
+
+  /* Allocates uninitialised memory for capacity elements, returns the inline
+   * storage if they fit in it */
+  T *allocate(size_t capacity) {
+    if (InlineCapacity > 0 && capacity <= InlineCapacity) {
+      return m_inline.data();
     }
-    m_data = new T[m_capacity];
+    return capacity > 0 ? allocator_traits::allocate(m_allocator, capacity)
+                        : nullptr;
   }
 
-  /* expands internal data array size by the chuck size
-   * and copying data to it */
-  void expand() {
+  /* Deallocates memory of the internal data array, elements must already be
+   * destroyed */
+  void deallocate() {
+    if (is_inline()) {
+      m_data = nullptr;
+    } else if (m_data) {
+      allocator_traits::deallocate(m_allocator, m_data, m_capacity);
+      m_data = nullptr;
+    }
+  }
+
+  /* Returns the capacity to expand to from the current capacity, following
+   * the growth policy of the list */
+  size_t next_capacity() {
     if (m_chunk_size == 0) {
       m_chunk_size = k_default_chunk_size;
     }
-    auto old_data = m_data;
-    m_capacity += m_chunk_size;
-    m_data = new T[m_capacity];
-    std::copy(old_data, old_data + m_length, m_data);
-    delete[] old_data;
+    size_t chunked = m_capacity + m_chunk_size;
+    if (m_growth_factor <= 1.0) {
+      return chunked;
+    }
+    return std::max(chunked, (size_t)(m_capacity * m_growth_factor));
+  }
+
+  /* Grow capacity following the growth policy until it accomodates length,
+   * then allocate to that capacity */
+  void fit_and_allocate() {
+    while (m_capacity < m_length) {
+      m_capacity = next_capacity();
+    }
+    m_data = allocate(m_capacity);
+  }
+
+  /* reallocates internal data array to new_capacity, moving data to it */
+  void reallocate(size_t new_capacity) {
+    assert(new_capacity >= m_length);
+    T *new_data = allocate(new_capacity);
+    std::uninitialized_move(m_data, m_data + m_length, new_data);
+    destroy_elements();
+    deallocate();
+    m_capacity = new_capacity;
+    m_data = new_data;
+  }
+
+  /* expands internal data array size following the growth policy */
+  void expand() { reallocate(next_capacity()); }
+
+  /* expands, if necessary, to make room for count more elements */
+  void expand_for(size_t count) {
+    if (m_length + count > m_capacity) {
+      reallocate(std::max(next_capacity(), m_length + count));
+    }
+  }
+
+  /* inserts count elements read from first at the current position, shifting
+   * the following elements only once */
+  template <class I> void insert_n(I first, size_t count) {
+    if (count == 0) {
+      return;
+    }
+    expand_for(count);
+
+    T *pos = m_data + m_pos;
+    T *end = m_data + m_length;
+    size_t shifted = m_length - m_pos;
+    if (shifted > count) {
+      // last count elements move into uninitialised memory, rest of the
+      // shifted elements and the inserted ones are assigned
+      std::uninitialized_move(end - count, end, end);
+      std::move_backward(pos, end - count, end);
+      std::copy_n(first, count, pos);
+    } else {
+      // every shifted element moves into uninitialised memory, inserted
+      // elements are assigned over the moved from ones and constructed
+      // after them
+      std::uninitialized_move(pos, end, pos + count);
+      for (size_t i = 0; i < shifted; i++, ++first) {
+        pos[i] = *first;
+      }
+      std::uninitialized_copy_n(first, count - shifted, end);
+    }
+    m_length += count;
   }
 
   /* destruct all elements */
   void destroy_elements() {
     for (size_t i = 0; i < m_length; i++) {
-      if constexpr (std::destructible<T>) {
-        m_data[i].~T();
-      }
+      allocator_traits::destroy(m_allocator, m_data + i);
     }
   }
 
 public:
+  /* Return the number of elements the list can hold without expanding. */
+  inline size_t capacity() const { return m_capacity; }
+
+  /* Expand capacity to hold at least new_capacity elements. Has no effect if
+   * capacity is already large enough. */
+  void reserve(size_t new_capacity) {
+    CHECK_STATE();
+    if (new_capacity > m_capacity) {
+      reallocate(new_capacity);
+    }
+  }
+
+  /* Reduce capacity to the number of elements in the list, or the inline
+   * capacity if they fit in it. */
+  void shrink_to_fit() {
+    CHECK_STATE();
+    size_t fit = std::max(m_length, InlineCapacity);
+    if (m_capacity > fit) {
+      reallocate(fit);
+    }
+  }
+
   /*  list interface implementation */
 
   /* Clears list, destroying all elements and emptying list. Leaves capacity
@@ -171,31 +356,67 @@ public:
     m_pos = m_length = 0;
   }
 
-  /* Inserts element at current position. Expands if necessary. */
-  void insert(const T &item) override {
+  /* Constructs element at current position from params. Expands if
+   * necessary. */
+  template <class... R>
+  requires std::constructible_from<T, R...>
+  void emplace(R &&...params) {
     CHECK_STATE();
 
+    if (m_pos == m_length) {
+      // list is empty, nothing to shift
+      emplace_back(std::forward<R>(params)...);
+      return;
+    }
+    // params may refer to an element of this list, so construct before
+    // shifting or expanding
+    T item(std::forward<R>(params)...);
     if (m_length >= m_capacity) {
       expand();
     }
-    // shift data to the right
-    for (size_t i = m_length; i > m_pos; i--) {
-      m_data[i] = m_data[i - 1];
-    }
-    m_data[m_pos] = item;
+    // shift data to the right, last element moves into uninitialised memory
+    allocator_traits::construct(m_allocator, m_data + m_length,
+                                std::move(m_data[m_length - 1]));
+    std::move_backward(m_data + m_pos, m_data + m_length - 1,
+                       m_data + m_length);
+    m_data[m_pos] = std::move(item);
     m_length++;
   }
 
-  /* Appends an element at the end of the list. Expands if necessary. */
-  void append(const T &item) override {
+  /* Constructs element at the end of the list from params. Expands if
+   * necessary. */
+  template <class... R>
+  requires std::constructible_from<T, R...>
+  void emplace_back(R &&...params) {
     CHECK_STATE();
 
     if (m_length >= m_capacity) {
+      // params may refer to an element of this list, so construct before
+      // expanding
+      T item(std::forward<R>(params)...);
       expand();
+      allocator_traits::construct(m_allocator, m_data + m_length,
+                                  std::move(item));
+    } else {
+      allocator_traits::construct(m_allocator, m_data + m_length,
+                                  std::forward<R>(params)...);
     }
-    m_data[m_length++] = item;
+    m_length++;
   }
 
+  /* Inserts copy of element at current position. Expands if necessary. */
+  void insert(const T &item) override { emplace(item); }
+
+  /* Inserts element at current position by moving it. Expands if necessary. */
+  void insert(T &&item) override { emplace(std::move(item)); }
+
+  /* Appends copy of element at the end of the list. Expands if necessary. */
+  void append(const T &item) override { emplace_back(item); }
+
+  /* Appends element at the end of the list by moving it. Expands if
+   * necessary. */
+  void append(T &&item) override { emplace_back(std::move(item)); }
+
   /* Remove element at current position and return it. */
   T remove() override {
     CHECK_STATE();
@@ -205,11 +426,10 @@ public:
     }
 
     assert(m_pos < m_length);
-    T ret = m_data[m_pos];
-    // shift data to the left
-    for (size_t i = m_pos; i < m_length - 1; i++) {
-      m_data[i] = m_data[i + 1];
-    }
+    T ret = std::move(m_data[m_pos]);
+    // shift data to the left, then destroy the now moved from last element
+    std::move(m_data + m_pos + 1, m_data + m_length, m_data + m_pos);
+    allocator_traits::destroy(m_allocator, m_data + m_length - 1);
     m_length--;
     if (m_pos == m_length && m_pos > 0) {
       m_pos--;
@@ -217,6 +437,64 @@ public:
     return ret;
   }
 
+  /* Inserts the elements of [first, last) at the current position, shifting
+   * the following elements only once. The current position is at the first
+   * inserted element afterwards. The range must not refer to elements of this
+   * list. */
+  template <std::input_iterator I>
+  requires std::constructible_from<T, std::iter_reference_t<I>>
+  void insert(I first, I last) {
+    CHECK_STATE();
+
+    if constexpr (!std::forward_iterator<I>) {
+      // length of a single pass range is only known after reading it
+      ArrayList buffer;
+      for (; first != last; ++first) {
+        buffer.emplace_back(*first);
+      }
+      insert_n(std::make_move_iterator(buffer.begin()), buffer.length());
+    } else {
+      insert_n(first, std::distance(first, last));
+    }
+  }
+
+  /* Appends every element of range at the end of the list, expanding at most
+   * once if the size of the range is known. */
+  template <std::ranges::input_range R>
+  requires(!std::convertible_to<R, T>) &&
+      std::constructible_from<T, std::ranges::range_reference_t<R>>
+  void append(R &&range) {
+    CHECK_STATE();
+
+    if constexpr (std::ranges::sized_range<R>) {
+      expand_for(std::ranges::size(range));
+    }
+    for (auto &&item : range) {
+      emplace_back(std::forward<decltype(item)>(item));
+    }
+  }
+
+  /* Removes count elements starting from the current position, shifting the
+   * following elements only once. */
+  void remove(size_t count) {
+    CHECK_STATE();
+
+    if (count > m_length - m_pos) {
+      throw std::runtime_error("Attempt to remove beyond the end of the list.");
+    }
+    if (count == 0) {
+      return;
+    }
+    std::move(m_data + m_pos + count, m_data + m_length, m_data + m_pos);
+    for (size_t i = m_length - count; i < m_length; i++) {
+      allocator_traits::destroy(m_allocator, m_data + i);
+    }
+    m_length -= count;
+    if (m_pos >= m_length) {
+      m_pos = m_length > 0 ? m_length - 1 : 0;
+    }
+  }
+
   /* Set the current position at the start of the list. */
   inline void moveToStart() override {
     CHECK_STATE();
@@ -273,7 +551,7 @@ public:
   }
 
   /* Return the value of the current element */
-  inline T getValue() const override {
+  inline const T &getValue() const override {
     CHECK_STATE();
     if (m_length == 0) {
       throw std::runtime_error("Attempting to access element from empty list.");
@@ -284,14 +562,94 @@ public:
   /* Search for an item in the list, returns npos ( (size_t) -1 ) if not found.
    */
   size_t Search(const T &item) const override {
-    for (size_t i = 0; i < m_length; i++) {
-      if (m_data[i] == item) {
-        return i;
-      }
+    // vectorised for arithmetic types
+    size_t i = simd::find(m_data, m_length, item);
+    return i < m_length ? i : npos;
+  }
+
+  /* Returns the positions of every occurence of item in the list, in
+   * increasing order. */
+  ArrayList<size_t> SearchAll(const T &item) const {
+    ArrayList<size_t> positions;
+    simd::for_each_match(m_data, m_length, item,
+                         [&](size_t i) { positions.append(i); });
+    return positions;
+  }
+
+  /* Returns the number of occurences of item in the list. */
+  size_t count(const T &item) const {
+    return simd::count(m_data, m_length, item);
+  }
+
+  /* Writes the length, the current position and then the elements to a
+   * binary stream. Trivially copyable elements are written straight from
+   * the storage of the list. */
+  void serialize(std::ostream &out) const
+    requires BinarySerializable<T>
+  {
+    serialization::write_header(out, m_length, m_pos);
+    serialization::write_items(out, m_data, m_length);
+  }
+
+  /* Replaces the contents of the list with a list written by serialize.
+   * Trivially copyable elements are read straight into the storage. */
+  void deserialize(std::istream &in)
+    requires BinarySerializable<T>
+  {
+    auto [length, pos] = serialization::read_header(in);
+    clear();
+    reserve(length);
+    if constexpr (std::is_trivially_copyable_v<T>) {
+      serialization::read_bytes(in, m_data, length * sizeof(T));
+      m_length = length;
+    } else {
+      serialization::read_items<T>(
+          in, length, [this](T &&item) { emplace_back(std::move(item)); });
     }
-    return npos;
+    m_pos = pos;
   }
+
+  /* Iterators over the elements, they do not move the current position */
+
+  using iterator = T *;
+  using const_iterator = const T *;
+
+  inline iterator begin() { return m_data; }
+  inline iterator end() { return m_data + m_length; }
+  inline const_iterator begin() const { return m_data; }
+  inline const_iterator end() const { return m_data + m_length; }
+  inline const_iterator cbegin() const { return m_data; }
+  inline const_iterator cend() const { return m_data + m_length; }
+
 #undef CHECK_STATE
 };
 
+/* Types whose values are equal exactly when their bytes are */
+template <class T>
+concept BitwiseComparable =
+    (std::integral<T> || std::is_enum_v<T> || std::is_pointer_v<T>) &&
+    std::has_unique_object_representations_v<T>;
+
+/* Array list that stores up to N elements without allocating */
+template <class T, std::size_t N, class Allocator = std::allocator<T>>
+using SmallArrayList = ArrayList<T, Allocator, N>;
+
+/* Check element-wise equality between array lists by comparing their
+ * storage directly, stops at the first difference */
+template <class T, class A1, std::size_t N1, class A2, std::size_t N2>
+bool operator==(const ArrayList<T, A1, N1> &a,
+                const ArrayList<T, A2, N2> &b) {
+  if (a.length() != b.length()) {
+    return false;
+  }
+  if (a.length() == 0) {
+    return true;
+  }
+  if constexpr (BitwiseComparable<T>) {
+    return std::memcmp(a.begin(), b.begin(), a.length() * sizeof(T)) == 0;
+  } else {
+    return std::equal(a.begin(), a.end(), b.begin());
+  }
+}
+
 } // namespace cse204
@@ -0,0 +1,552 @@
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "arraylist.h"
+#include "concurrentlist.h"
+#include "indexedskiplist.h"
+#include "linkedlist.h"
+#include "persistentlist.h"
+#include "unrolledlinkedlist.h"
+
+// return time required to perform task in milliseconds
+float benchmark(auto &&task, int n = 5) {
+  double duration = 0.0;
+  int t = n;
+  while (t--) {
+    auto start = std::chrono::high_resolution_clock::now();
+    task();
+    duration +=
+        (std::chrono::high_resolution_clock::now() - start).count() / 1e6;
+  }
+  return duration / n;
+}
+
+template <class... R, class T>
+void print_comma_seperated(std::ostream &os, T &&a, R &&...rest) {
+  os << a;
+  if constexpr (sizeof...(rest)) {
+    os << ',';
+    print_comma_seperated(os, rest...);
+  } else {
+    os << std::endl;
+  }
+}
+
+// average time of a single append in nanoseconds
+float append_time(int N, double growth_factor) {
+  auto task = [=]() {
+    cse204::ArrayList<int> list(cse204::ArrayList<int>::k_default_chunk_size,
+                                growth_factor);
+    for (int i = 0; i < N; i++) {
+      list.append(i);
+    }
+  };
+  return benchmark(task) * 1e6 / N;
+}
+
+void benchmark_append(std::ostream &out) {
+  int N[] = {1000, 10000, 100000, 1000000};
+  print_comma_seperated(out, ' ', ' ', "Time required per append in ns");
+  print_comma_seperated(out, 'n', "Chunked Growth", "Geometric Growth");
+
+  for (int n : N) {
+    // chunked growth is quadratic, so skip it for very large lists
+    if (n <= 100000) {
+      print_comma_seperated(out, n, append_time(n, 1.0), append_time(n, 2.0));
+    } else {
+      print_comma_seperated(out, n, ' ', append_time(n, 2.0));
+    }
+  }
+}
+
+// sum of the list traversed through the vtable of the List interface
+[[gnu::noinline]] long long traverse_virtual(cse204::List<int> &list) {
+  long long sum = 0;
+  list.moveToStart();
+  for (size_t i = 0; i < list.length(); i++, list.next()) {
+    sum += list.getValue();
+  }
+  return sum;
+}
+
+// sum of the list traversed through calls resolved at compile time
+[[gnu::noinline]] long long traverse_static(cse204::ListADT auto &list) {
+  long long sum = 0;
+  list.moveToStart();
+  for (size_t i = 0; i < list.length(); i++, list.next()) {
+    sum += list.getValue();
+  }
+  return sum;
+}
+
+// average time of visiting a single element in nanoseconds
+template <template <typename> typename list_type>
+float traversal_time(int N, auto &&traverse) {
+  list_type<int> list;
+  for (int i = 0; i < N; i++) {
+    list.append(i);
+  }
+  volatile long long sink;
+  return benchmark([&]() { sink = traverse(list); }) * 1e6 / N;
+}
+
+void benchmark_dispatch(std::ostream &out) {
+  int N[] = {1000, 10000, 100000, 1000000};
+  print_comma_seperated(out, ' ', ' ', ' ', ' ',
+                        "Time required per element in ns");
+  print_comma_seperated(out, 'n', "ArrayList Virtual", "ArrayList Static",
+                        "LinkedList Virtual", "LinkedList Static");
+
+  auto dynamic = [](auto &list) { return traverse_virtual(list); };
+  auto compile_time = [](auto &list) { return traverse_static(list); };
+
+  for (int n : N) {
+    print_comma_seperated(out, n,
+                          traversal_time<cse204::ArrayList>(n, dynamic),
+                          traversal_time<cse204::ArrayList>(n, compile_time),
+                          traversal_time<cse204::LinkedList>(n, dynamic),
+                          traversal_time<cse204::LinkedList>(n, compile_time));
+  }
+}
+
+// linear search the way ArrayList did before vectorisation
+template <class T>
+[[gnu::noinline]] size_t scalar_search(const cse204::ArrayList<T> &list,
+                                       const T &item) {
+  size_t i = 0;
+  for (const T &v : list) {
+    if (v == item) {
+      return i;
+    }
+    i++;
+  }
+  return -1;
+}
+
+// average time of searching for an absent element per element in ns
+template <class T> float search_time(int N, auto &&search) {
+  cse204::ArrayList<T> list;
+  for (int i = 0; i < N; i++) {
+    list.append(T(i));
+  }
+  volatile size_t sink;
+  return benchmark([&]() { sink = search(list, T(-1)); }, 20) * 1e6 / N;
+}
+
+template <class T> void benchmark_search_type(std::ostream &out, int n) {
+  auto scalar = [](auto &list, T item) { return scalar_search(list, item); };
+  auto search = [](auto &list, T item) { return list.Search(item); };
+  auto count = [](auto &list, T item) { return list.count(item); };
+  auto search_all = [](auto &list, T item) {
+    return list.SearchAll(item).length();
+  };
+  print_comma_seperated(out, search_time<T>(n, scalar),
+                        search_time<T>(n, search), search_time<T>(n, count),
+                        search_time<T>(n, search_all));
+}
+
+void benchmark_search(std::ostream &out) {
+  int N[] = {1000, 10000, 100000, 1000000};
+  print_comma_seperated(out, ' ', ' ', ' ', ' ',
+                        "Time required per element in ns");
+  print_comma_seperated(out, 'n', "type", "Scalar Loop", "Search", "count",
+                        "SearchAll");
+
+  for (int n : N) {
+    out << n << ",int,";
+    benchmark_search_type<int>(out, n);
+    out << n << ",float,";
+    benchmark_search_type<float>(out, n);
+  }
+}
+
+// bytes currently allocated through every CountingAllocator
+long long allocated_bytes = 0;
+
+// allocator that keeps track of the memory used by a container, including
+// the nodes it rebinds the allocator to
+template <class T> struct CountingAllocator {
+  using value_type = T;
+
+  CountingAllocator() = default;
+  template <class U> CountingAllocator(const CountingAllocator<U> &) {}
+
+  T *allocate(size_t n) {
+    allocated_bytes += n * sizeof(T);
+    return std::allocator<T>().allocate(n);
+  }
+  void deallocate(T *p, size_t n) {
+    allocated_bytes -= n * sizeof(T);
+    std::allocator<T>().deallocate(p, n);
+  }
+  bool operator==(const CountingAllocator &) const = default;
+};
+
+// bytes allocated per element by a list of N appended ints
+template <class list_type> float memory_per_element(int N) {
+  long long before = allocated_bytes;
+  list_type list;
+  for (int i = 0; i < N; i++) {
+    list.append(i);
+  }
+  return float(allocated_bytes - before) / N;
+}
+
+void benchmark_memory(std::ostream &out) {
+  using counted = CountingAllocator<int>;
+  int N[] = {10, 100, 1000, 10000, 100000, 1000000};
+  print_comma_seperated(out, ' ', ' ', "Bytes allocated per element");
+  print_comma_seperated(out, 'n', "ArrayList", "LinkedList",
+                        "UnrolledLinkedList");
+
+  for (int n : N) {
+    print_comma_seperated(
+        out, n, memory_per_element<cse204::ArrayList<int, counted>>(n),
+        memory_per_element<cse204::LinkedList<int, counted>>(n),
+        memory_per_element<cse204::UnrolledLinkedList<int, 32, counted>>(n));
+  }
+}
+
+// sum of the list traversed with its iterators
+[[gnu::noinline]] long long traverse_iterator(const auto &list) {
+  long long sum = 0;
+  for (int v : list) {
+    sum += v;
+  }
+  return sum;
+}
+
+template <class T> using UnrolledLinkedList = cse204::UnrolledLinkedList<T>;
+
+void benchmark_traversal(std::ostream &out) {
+  int N[] = {1000, 10000, 100000, 1000000};
+  print_comma_seperated(out, ' ', ' ', ' ', ' ', ' ', ' ',
+                        "Time required per element in ns");
+  print_comma_seperated(out, 'n', "ArrayList Cursor", "ArrayList Iterator",
+                        "LinkedList Cursor", "LinkedList Iterator",
+                        "UnrolledLinkedList Cursor",
+                        "UnrolledLinkedList Iterator");
+
+  auto cursor = [](auto &list) { return traverse_static(list); };
+  auto iterator = [](auto &list) { return traverse_iterator(list); };
+
+  for (int n : N) {
+    print_comma_seperated(out, n, traversal_time<cse204::ArrayList>(n, cursor),
+                          traversal_time<cse204::ArrayList>(n, iterator),
+                          traversal_time<cse204::LinkedList>(n, cursor),
+                          traversal_time<cse204::LinkedList>(n, iterator),
+                          traversal_time<UnrolledLinkedList>(n, cursor),
+                          traversal_time<UnrolledLinkedList>(n, iterator));
+  }
+}
+
+// average time in nanoseconds of moving to a random position and inserting
+// there, then moving to another and removing, in a list of N elements
+template <template <typename> typename list_type>
+float positional_update_time(int N) {
+  list_type<int> list;
+  for (int i = 0; i < N; i++) {
+    list.append(i);
+  }
+  const int updates = 1000;
+  unsigned seed = 1;
+  auto random = [&]() {
+    seed = seed * 1103515245 + 12345;
+    return (seed >> 4) % N;
+  };
+  auto task = [&]() {
+    for (int i = 0; i < updates; i++) {
+      list.moveToPos(random());
+      list.insert(i);
+      list.moveToPos(random());
+      list.remove();
+    }
+  };
+  return benchmark(task, 3) * 1e6 / updates;
+}
+
+void benchmark_scaling(std::ostream &out) {
+  int N[] = {1000, 10000, 100000, 1000000, 10000000};
+  print_comma_seperated(out, ' ', ' ', "Time required per update in ns");
+  print_comma_seperated(out, 'n', "ArrayList", "LinkedList",
+                        "IndexedSkipList");
+
+  for (int n : N) {
+    // linked list seeks are linear, skip it for very large lists
+    if (n <= 100000) {
+      print_comma_seperated(
+          out, n, positional_update_time<cse204::ArrayList>(n),
+          positional_update_time<cse204::LinkedList>(n),
+          positional_update_time<cse204::IndexedSkipList>(n));
+    } else {
+      print_comma_seperated(
+          out, n, positional_update_time<cse204::ArrayList>(n), ' ',
+          positional_update_time<cse204::IndexedSkipList>(n));
+    }
+  }
+}
+
+// array list behind a single mutex, the alternative to a concurrent list
+struct LockedArrayList {
+  std::mutex mutex;
+  cse204::ArrayList<int> list;
+
+  void append(int item) {
+    std::lock_guard lock(mutex);
+    list.append(item);
+  }
+
+  size_t Search(int item) {
+    std::lock_guard lock(mutex);
+    return list.Search(item);
+  }
+};
+
+// millions of appends per second while the given number of threads append N
+// ints in total, and one more thread keeps searching the list
+template <class list_type> float concurrent_append_rate(int N, int threads) {
+  auto task = [=]() {
+    list_type list;
+    std::atomic<bool> done = false;
+    std::thread reader([&]() {
+      while (!done) {
+        list.Search(-1);
+      }
+    });
+    std::vector<std::thread> writers;
+    for (int t = 0; t < threads; t++) {
+      writers.emplace_back([&]() {
+        for (int i = 0; i < N / threads; i++) {
+          list.append(i);
+        }
+      });
+    }
+    for (auto &writer : writers) {
+      writer.join();
+    }
+    done = true;
+    reader.join();
+  };
+  return N / (benchmark(task, 3) * 1e3);
+}
+
+void benchmark_concurrent(std::ostream &out) {
+  const int N = 1000000;
+  int threads[] = {1, 2, 4, 8};
+  print_comma_seperated(out, ' ', ' ', "Million appends per second");
+  print_comma_seperated(out, "Threads", "ConcurrentList", "Locked ArrayList");
+
+  for (int t : threads) {
+    print_comma_seperated(out, t,
+                          concurrent_append_rate<cse204::ConcurrentList<int>>(
+                              N, t),
+                          concurrent_append_rate<LockedArrayList>(N, t));
+  }
+}
+
+// average time in nanoseconds of taking a snapshot of a list of N elements,
+// optionally inserting into the snapshot at a random position, and then
+// dropping it
+template <template <typename> typename list_type>
+float snapshot_time(int N, bool update) {
+  list_type<int> list;
+  for (int i = 0; i < N; i++) {
+    list.append(i);
+  }
+  const int snapshots = 100;
+  unsigned seed = 1;
+  auto task = [&]() {
+    for (int i = 0; i < snapshots; i++) {
+      list_type<int> snapshot = list;
+      if (update) {
+        seed = seed * 1103515245 + 12345;
+        snapshot.moveToPos((seed >> 4) % N);
+        snapshot.insert(i);
+      }
+    }
+  };
+  return benchmark(task, 3) * 1e6 / snapshots;
+}
+
+void benchmark_snapshot(std::ostream &out) {
+  int N[] = {1000, 10000, 100000, 1000000};
+  print_comma_seperated(out, ' ', ' ', ' ', ' ',
+                        "Time required per snapshot in ns");
+  print_comma_seperated(out, 'n', "ArrayList Copy", "LinkedList Copy",
+                        "PersistentList Snapshot",
+                        "PersistentList Snapshot and Insert");
+
+  for (int n : N) {
+    // copying every node takes too long for the largest list
+    if (n <= 100000) {
+      print_comma_seperated(
+          out, n, snapshot_time<cse204::ArrayList>(n, false),
+          snapshot_time<cse204::LinkedList>(n, false),
+          snapshot_time<cse204::PersistentList>(n, false),
+          snapshot_time<cse204::PersistentList>(n, true));
+    } else {
+      print_comma_seperated(
+          out, n, snapshot_time<cse204::ArrayList>(n, false), ' ',
+          snapshot_time<cse204::PersistentList>(n, false),
+          snapshot_time<cse204::PersistentList>(n, true));
+    }
+  }
+}
+
+// 64 byte element, compared by its key only
+struct Record {
+  long long key;
+  char payload[56] = {};
+
+  Record(long long key = 0) : key(key) {}
+  bool operator==(const Record &other) const { return key == other.key; }
+};
+static_assert(sizeof(Record) == 64);
+
+template <class T> T make_item(int i) {
+  if constexpr (std::same_as<T, std::string>) {
+    return std::to_string(i);
+  } else {
+    return T(i);
+  }
+}
+
+// Freeing millions of nodes leaves them in the fast bins of glibc malloc,
+// which the next larger allocation merges all at once, adding microseconds
+// to the first append after the largest lists. Have that happen outside of
+// the timed code. Returns whether the block was allocated, the address is
+// read back through a volatile so the allocation cannot be optimised away.
+bool settle_allocator() {
+  static void *volatile sink;
+  std::vector<char> block(4096);
+  sink = block.data();
+  return sink != nullptr;
+}
+
+// average time in nanoseconds of append, of insert followed by remove at the
+// middle, of moveToPos to a random position, of a Search for an absent
+// element and of clear per element, on a list of N elements
+template <class list_type> std::array<float, 5> operation_times(int N) {
+  using T = typename list_type::value_type;
+  // fewer repetitions of the linear operations on large lists
+  const int ops = std::clamp(10000000 / N, 10, 1000);
+  settle_allocator();
+  list_type list;
+  std::array<float, 5> times;
+
+  // small lists are filled several times from empty for a stable average
+  const int fills = std::clamp(1000000 / N, 1, 100);
+  float fill_time = 0;
+  for (int f = 0; f < fills; f++) {
+    list = list_type();
+    fill_time += benchmark(
+        [&]() {
+          for (int i = 0; i < N; i++) {
+            list.append(make_item<T>(i));
+          }
+        },
+        1);
+  }
+  times[0] = fill_time / fills * 1e6 / N;
+
+  const T item = make_item<T>(-1);
+  list.moveToPos(N / 2);
+  times[1] = benchmark(
+                 [&]() {
+                   for (int i = 0; i < ops; i++) {
+                     list.insert(item);
+                     list.remove();
+                   }
+                 },
+                 1) *
+             1e6 / ops;
+
+  unsigned seed = 1;
+  times[2] = benchmark(
+                 [&]() {
+                   for (int i = 0; i < ops; i++) {
+                     seed = seed * 1103515245 + 12345;
+                     list.moveToPos((seed >> 4) % N);
+                   }
+                 },
+                 1) *
+             1e6 / ops;
+
+  volatile size_t sink;
+  times[3] = benchmark(
+                 [&]() {
+                   for (int i = 0; i < ops; i++) {
+                     sink = list.Search(item);
+                   }
+                 },
+                 1) *
+             1e6 / ops;
+
+  times[4] = benchmark([&]() { list.clear(); }, 1) * 1e6 / N;
+  return times;
+}
+
+template <class T> void benchmark_operations(std::ostream &out) {
+  int N[] = {10, 100, 1000, 10000, 100000, 1000000, 10000000};
+  print_comma_seperated(out, ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ',
+                        "Time required per operation in ns, per element "
+                        "for Clear");
+  print_comma_seperated(out, 'n', "ArrayList Append", "LinkedList Append",
+                        "ArrayList Insert and Remove",
+                        "LinkedList Insert and Remove", "ArrayList moveToPos",
+                        "LinkedList moveToPos", "ArrayList Search",
+                        "LinkedList Search", "ArrayList Clear",
+                        "LinkedList Clear");
+
+  for (int n : N) {
+    auto array = operation_times<cse204::ArrayList<T>>(n);
+    auto linked = operation_times<cse204::LinkedList<T>>(n);
+    print_comma_seperated(out, n, array[0], linked[0], array[1], linked[1],
+                          array[2], linked[2], array[3], linked[3], array[4],
+                          linked[4]);
+  }
+}
+
+int main() {
+  std::ofstream append_file("append.csv");
+  benchmark_append(append_file);
+
+  std::ofstream dispatch_file("dispatch.csv");
+  benchmark_dispatch(dispatch_file);
+
+  std::ofstream search_file("search.csv");
+  benchmark_search(search_file);
+
+  std::ofstream memory_file("memory.csv");
+  benchmark_memory(memory_file);
+
+  std::ofstream traversal_file("traversal.csv");
+  benchmark_traversal(traversal_file);
+
+  std::ofstream scaling_file("scaling.csv");
+  benchmark_scaling(scaling_file);
+
+  std::ofstream concurrent_file("concurrent.csv");
+  benchmark_concurrent(concurrent_file);
+
+  std::ofstream snapshot_file("snapshot.csv");
+  benchmark_snapshot(snapshot_file);
+
+  std::ofstream int_file("operations_int.csv");
+  benchmark_operations<int>(int_file);
+
+  std::ofstream string_file("operations_string.csv");
+  benchmark_operations<std::string>(string_file);
+
+  std::ofstream record_file("operations_record.csv");
+  benchmark_operations<Record>(record_file);
+  return 0;
+}
@@ -0,0 +1,255 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cassert>
+#include <concepts>
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+
+namespace cse204 {
+
+/* Append only list that many threads can append to and read from at the
+ * same time. Elements are stored in segments that double in size and are
+ * never moved, so a reference to an element stays valid until the list is
+ * cleared or destroyed.
+ *
+ * append reserves an index with a single atomic increment and is lock-free.
+ * An element becomes visible once it and every element before it are
+ * constructed, readers only ever see this published prefix. length, at,
+ * Search and iteration are wait-free. Since elements cannot be removed or
+ * inserted, the cursor operations of the List interface are not provided.
+ *
+ * clear and the destructor must not run while other threads use the list,
+ * and the allocator must be safe to use from several threads at once. */
+template <class T, class Allocator = std::allocator<T>>
+requires std::is_nothrow_move_constructible_v<T>
+class ConcurrentList {
+public:
+  using size_t = std::size_t;
+  using value_type = T;
+
+  static constexpr size_t npos = (size_t)-1;
+
+private:
+  /* first segment holds 2^k_first_segment_bits elements */
+  static constexpr size_t k_first_segment_bits = 5;
+  static constexpr size_t k_first_segment_size = size_t(1)
+                                                 << k_first_segment_bits;
+  static constexpr size_t k_max_segments =
+      sizeof(size_t) * 8 - k_first_segment_bits;
+
+  struct slot {
+    /* set once value is constructed */
+    std::atomic<bool> ready;
+    union {
+      T value;
+    };
+
+    slot() : ready(false) {}
+    ~slot() {}
+  };
+
+  using allocator_type =
+      typename std::allocator_traits<Allocator>::template rebind_alloc<slot>;
+  using allocator_traits =
+      typename std::allocator_traits<Allocator>::template rebind_traits<slot>;
+
+  allocator_type m_allocator;
+
+  /* segment s holds k_first_segment_size << s elements, nullptr until an
+   * element is appended to it */
+  std::atomic<slot *> m_segments[k_max_segments] = {};
+  /* number of indices handed out to appending threads */
+  std::atomic<size_t> m_reserved = 0;
+  /* number of elements visible to readers, every one of them is ready */
+  std::atomic<size_t> m_length = 0;
+
+  static inline size_t segment_size(size_t segment) {
+    return k_first_segment_size << segment;
+  }
+
+  /* segment of an index, and the index within that segment */
+  static inline size_t segment_of(size_t i) {
+    return std::bit_width(i + k_first_segment_size) - 1 - k_first_segment_bits;
+  }
+
+  static inline size_t offset_of(size_t i, size_t segment) {
+    return i + k_first_segment_size - segment_size(segment);
+  }
+
+  inline slot &slot_at(size_t i) const {
+    size_t s = segment_of(i);
+    return m_segments[s].load(std::memory_order_acquire)[offset_of(i, s)];
+  }
+
+  /* Whether element i is constructed, its segment may not exist yet */
+  bool is_ready(size_t i) const {
+    size_t s = segment_of(i);
+    const slot *segment = m_segments[s].load(std::memory_order_acquire);
+    return segment && segment[offset_of(i, s)].ready.load();
+  }
+
+  /* Returns segment s, allocating it if no other thread has yet */
+  slot *get_segment(size_t s) {
+    slot *segment = m_segments[s].load(std::memory_order_acquire);
+    if (segment) {
+      return segment;
+    }
+    slot *created = allocator_traits::allocate(m_allocator, segment_size(s));
+    for (size_t i = 0; i < segment_size(s); i++) {
+      allocator_traits::construct(m_allocator, created + i);
+    }
+    if (m_segments[s].compare_exchange_strong(segment, created,
+                                              std::memory_order_acq_rel)) {
+      return created;
+    }
+    // another thread installed its segment first
+    free_segment(created, s);
+    return segment;
+  }
+
+  void free_segment(slot *segment, size_t s) {
+    for (size_t i = 0; i < segment_size(s); i++) {
+      allocator_traits::destroy(m_allocator, segment + i);
+    }
+    allocator_traits::deallocate(m_allocator, segment, segment_size(s));
+  }
+
+  /* Advances the published length over every ready element. The thread
+   * that completes the element at the current length carries on, so the
+   * length never waits on an element that is already ready. */
+  void publish() {
+    size_t length = m_length.load();
+    while (is_ready(length)) {
+      // on failure length is reloaded, another thread went past it
+      m_length.compare_exchange_weak(length, length + 1);
+    }
+  }
+
+public:
+  /* Create empty list */
+  ConcurrentList() = default;
+
+  ConcurrentList(const ConcurrentList &) = delete;
+  ConcurrentList &operator=(const ConcurrentList &) = delete;
+
+  ~ConcurrentList() { clear(); }
+
+  /* Constructs element at the end of the list from params. The element is
+   * constructed before an index is reserved, so a throwing constructor
+   * leaves the list unchanged. */
+  template <class... R>
+  requires std::constructible_from<T, R...>
+  void emplace_back(R &&...params) {
+    T item(std::forward<R>(params)...);
+    size_t i = m_reserved.fetch_add(1);
+    size_t s = segment_of(i);
+    assert(s < k_max_segments);
+    slot &target = get_segment(s)[offset_of(i, s)];
+    ::new (std::addressof(target.value)) T(std::move(item));
+    target.ready.store(true);
+    publish();
+  }
+
+  /* Appends copy of element at the end of the list. */
+  void append(const T &item) { emplace_back(item); }
+
+  /* Appends element at the end of the list by moving it. */
+  void append(T &&item) { emplace_back(std::move(item)); }
+
+  /* Return the number of elements visible to this thread. */
+  inline size_t length() const {
+    return m_length.load(std::memory_order_acquire);
+  }
+
+  /* Return element at index i, which must be less than the length. */
+  const T &at(size_t i) const {
+    if (i >= length()) {
+      throw std::runtime_error("Attempt to access element beyond the length "
+                               "of the list.");
+    }
+    return slot_at(i).value;
+  }
+
+  /* Search for an item among the elements visible to this thread, returns
+   * npos ( (size_t) -1 ) if not found. */
+  size_t Search(const T &item) const {
+    const size_t n = length();
+    for (size_t s = 0, i = 0; i < n; s++) {
+      const slot *segment = m_segments[s].load(std::memory_order_acquire);
+      size_t end = std::min(n - i, segment_size(s));
+      for (size_t j = 0; j < end; j++) {
+        if (segment[j].value == item) {
+          return i + j;
+        }
+      }
+      i += end;
+    }
+    return npos;
+  }
+
+  /* Destroys every element and frees the segments. Not thread-safe. */
+  void clear() {
+    const size_t n = m_reserved.load();
+    for (size_t i = 0; i < n; i++) {
+      std::destroy_at(std::addressof(slot_at(i).value));
+    }
+    for (size_t s = 0; s < k_max_segments; s++) {
+      if (slot *segment = m_segments[s].load()) {
+        free_segment(segment, s);
+        m_segments[s].store(nullptr);
+      }
+    }
+    m_reserved.store(0);
+    m_length.store(0);
+  }
+
+  /* Iterator over the elements visible when end() is called */
+  class const_iterator {
+    const ConcurrentList *m_list = nullptr;
+    size_t m_index = 0;
+
+  public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = T;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const T *;
+    using reference = const T &;
+
+    const_iterator() = default;
+    const_iterator(const ConcurrentList *list, size_t index)
+        : m_list(list), m_index(index) {}
+
+    reference operator*() const { return m_list->slot_at(m_index).value; }
+    pointer operator->() const { return std::addressof(**this); }
+
+    const_iterator &operator++() {
+      m_index++;
+      return *this;
+    }
+
+    const_iterator operator++(int) {
+      const_iterator old = *this;
+      ++*this;
+      return old;
+    }
+
+    bool operator==(const const_iterator &other) const {
+      return m_index == other.m_index;
+    }
+  };
+
+  using iterator = const_iterator;
+
+  inline const_iterator begin() const { return const_iterator(this, 0); }
+  inline const_iterator end() const { return const_iterator(this, length()); }
+  inline const_iterator cbegin() const { return begin(); }
+  inline const_iterator cend() const { return end(); }
+};
+
+} // namespace cse204
@@ -9,6 +9,12 @@ std::optional<ListImplementationType> selectListImplementation(int argc,
     } else if (std::strcmp(argv[1], "-arr") == 0 ||
                std::strcmp(argv[1], "--arraylist") == 0) {
       return ListImplementationType::ARRAY_LIST;
+    } else if (std::strcmp(argv[1], "-gb") == 0 ||
+               std::strcmp(argv[1], "--gapbuffer") == 0) {
+      return ListImplementationType::GAP_BUFFER_LIST;
+    } else if (std::strcmp(argv[1], "-sl") == 0 ||
+               std::strcmp(argv[1], "--skiplist") == 0) {
+      return ListImplementationType::SKIP_LIST;
     }
   }
 
@@ -21,6 +27,12 @@ std::optional<ListImplementationType> selectListImplementation(int argc,
             << "-ll, --linkedlist\tTo test the linked list "
                "implementation of the list interface"
             << std::endl
+            << "-gb, --gapbuffer\tTo test the gap buffer "
+               "implementation of the list interface"
+            << std::endl
+            << "-sl, --skiplist\tTo test the indexed skip list "
+               "implementation of the list interface"
+            << std::endl
             << std::endl;
   return std::nullopt;
 }
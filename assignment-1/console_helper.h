@@ -6,10 +6,17 @@
 
 #include "list.h"
 
-enum class ListImplementationType { ARRAY_LIST, LINKED_LIST };
+enum class ListImplementationType {
+  ARRAY_LIST,
+  LINKED_LIST,
+  GAP_BUFFER_LIST,
+  SKIP_LIST
+};
 
+/* Implements both the virtual and the compile time list interface */
 template <template <typename> typename R>
-concept ImplementsList = std::derived_from<R<int>, cse204::List<int>>; 
+concept ImplementsList =
+    std::derived_from<R<int>, cse204::List<int>> && cse204::ListADT<R<int>>;
 
 /* Selects a list implentation type based on console args */
 std::optional<ListImplementationType> selectListImplementation(int argc,
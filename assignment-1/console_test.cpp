@@ -3,6 +3,8 @@
 #include <iostream>
 
 #include "arraylist.h"
+#include "gapbufferlist.h"
+#include "indexedskiplist.h"
 #include "linkedlist.h"
 
 #include "console_helper.h"
@@ -88,6 +90,12 @@ int main(int argc, char **argv) {
     case ListImplementationType::ARRAY_LIST:
       ListTester(cse204::ArrayList<int>(K, data, X)).test();
       break;
+    case ListImplementationType::GAP_BUFFER_LIST:
+      ListTester(cse204::GapBufferList<int>(K, data)).test();
+      break;
+    case ListImplementationType::SKIP_LIST:
+      ListTester(cse204::IndexedSkipList<int>(K, data)).test();
+      break;
     }
   }
 
@@ -0,0 +1,466 @@
+#pragma once
+
+#include <algorithm>
+#include <concepts>
+#include <cstring>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+
+#include "list.h"
+#include "simd_search.h"
+
+namespace cse204 {
+
+/* List stored in an array with a gap of unused capacity in it. The elements
+ * before the gap are at the start of the array and the ones after it at the
+ * end. Edits at the current position first move the gap there, so repeated
+ * inserts and removes around the cursor only shift the elements between the
+ * old and new position of the gap. Moving the cursor never moves the gap. */
+template <class T, class Allocator = std::allocator<T>>
+class GapBufferList final : public List<T> {
+
+  using typename List<T>::size_t;
+  using List<T>::npos;
+  using allocator_traits = std::allocator_traits<Allocator>;
+
+  static constexpr size_t k_default_capacity = 8;
+
+  Allocator m_allocator;
+
+  size_t m_capacity;
+  /* Elements are in [0, m_gap_start) and [m_gap_end, m_capacity), the gap in
+   * between is uninitialised memory */
+  size_t m_gap_start;
+  size_t m_gap_end;
+  size_t m_pos;
+
+  T *m_data;
+
+/* check validity of state */
+#define CHECK_STATE()                                                          \
+  assert(m_gap_start <= m_gap_end);                                            \
+  assert(m_gap_end <= m_capacity);                                             \
+  if (length() > 0) {                                                          \
+    assert(m_pos < length());                                                  \
+    assert(m_data);                                                            \
+  } else {                                                                     \
+    assert(m_pos == 0);                                                        \
+  }
+
+public:
+  /* Create empty list */
+  GapBufferList(size_t initial_capacity = k_default_capacity)
+      : m_capacity(initial_capacity), m_gap_start(0), m_gap_end(m_capacity),
+        m_pos(0), m_data(allocate(m_capacity)) {}
+
+  /* Create list from initializer list */
+  GapBufferList(std::initializer_list<T> items)
+      : GapBufferList(items.size(), items.begin()) {}
+
+  /* Create list with data from static array */
+  template <size_t N>
+  GapBufferList(T const (&items)[N]) : GapBufferList(N, items) {}
+
+  /* Create list with pointer data */
+  GapBufferList(size_t num_items, T const *items)
+      : m_capacity(std::max(num_items, k_default_capacity)),
+        m_gap_start(num_items), m_gap_end(m_capacity), m_pos(0),
+        m_data(allocate(m_capacity)) {
+    std::uninitialized_copy(items, items + num_items, m_data);
+  }
+
+  /* Copy constructor: copies elements from other list, along with the gap */
+  GapBufferList(const GapBufferList &other) requires std::copyable<T>
+      : m_capacity(other.m_capacity),
+        m_gap_start(other.m_gap_start),
+        m_gap_end(other.m_gap_end),
+        m_pos(other.m_pos),
+        m_data(allocate(m_capacity)) {
+    copy_from(other);
+  }
+
+  /* Move constructor: steals elements from other list */
+  GapBufferList(GapBufferList &&other)
+      : m_allocator(std::move(other.m_allocator)),
+        m_capacity(other.m_capacity), m_gap_start(other.m_gap_start),
+        m_gap_end(other.m_gap_end), m_pos(other.m_pos), m_data(other.m_data) {
+    /* Will resize to default capacity if inserted again */
+    other.m_capacity = other.m_gap_start = other.m_gap_end = other.m_pos = 0;
+    other.m_data = nullptr;
+  }
+
+  /* Copy assignment: copies elements from other list */
+  GapBufferList &operator=(const GapBufferList &other)
+    requires std::copyable<T>
+  {
+    if (this == &other) {
+      return *this;
+    }
+    destroy_elements();
+    if (m_capacity != other.m_capacity) {
+      deallocate();
+      m_capacity = other.m_capacity;
+      m_data = allocate(m_capacity);
+    }
+    m_gap_start = other.m_gap_start;
+    m_gap_end = other.m_gap_end;
+    m_pos = other.m_pos;
+    copy_from(other);
+    return *this;
+  }
+
+  /* Move assignment: steals elements from other list */
+  GapBufferList &operator=(GapBufferList &&other) {
+    if (this == &other) {
+      return *this;
+    }
+    // exchange data and capacity, but setting other empty
+    destroy_elements();
+    m_gap_start = other.m_gap_start;
+    m_gap_end = other.m_gap_end;
+    m_pos = other.m_pos;
+    // swap the arrays along with the allocators that own them
+    std::swap(m_allocator, other.m_allocator);
+    std::swap(m_capacity, other.m_capacity);
+    std::swap(m_data, other.m_data);
+    other.m_gap_start = other.m_pos = 0;
+    other.m_gap_end = other.m_capacity;
+    return *this;
+  }
+
+  /* Destructor */
+  ~GapBufferList() {
+    destroy_elements();
+    deallocate();
+  }
+
+private:
+  /* helper methods */
+
+  /* Allocates uninitialised memory for capacity elements */
+  T *allocate(size_t capacity) {
+    return capacity > 0 ? allocator_traits::allocate(m_allocator, capacity)
+                        : nullptr;
+  }
+
+  /* Deallocates memory of the internal data array, elements must already be
+   * destroyed */
+  void deallocate() {
+    if (m_data) {
+      allocator_traits::deallocate(m_allocator, m_data, m_capacity);
+      m_data = nullptr;
+    }
+  }
+
+  /* Number of unused slots in the array */
+  inline size_t gap_size() const { return m_gap_end - m_gap_start; }
+
+  /* Index in the array of the element at position pos of the list */
+  inline size_t physical(size_t pos) const {
+    return pos < m_gap_start ? pos : pos + gap_size();
+  }
+
+  /* Copies the elements of other list, which has the same capacity and gap */
+  void copy_from(const GapBufferList &other) {
+    std::uninitialized_copy(other.m_data, other.m_data + m_gap_start, m_data);
+    std::uninitialized_copy(other.m_data + m_gap_end,
+                            other.m_data + m_capacity, m_data + m_gap_end);
+  }
+
+  /* Destruct all elements */
+  void destroy_elements() {
+    for (size_t i = 0; i < m_gap_start; i++) {
+      allocator_traits::destroy(m_allocator, m_data + i);
+    }
+    for (size_t i = m_gap_end; i < m_capacity; i++) {
+      allocator_traits::destroy(m_allocator, m_data + i);
+    }
+  }
+
+  /* Moves count elements from src to dst, in the direction that is safe if
+   * the ranges overlap. Elements are moved into uninitialised memory and the
+   * sources are destroyed. */
+  void relocate(T *dst, T *src, size_t count) {
+    if (dst == src) {
+      return;
+    }
+    if constexpr (std::is_trivially_copyable_v<T>) {
+      std::memmove(static_cast<void *>(dst), src, count * sizeof(T));
+    } else if (dst < src) {
+      for (size_t i = 0; i < count; i++) {
+        allocator_traits::construct(m_allocator, dst + i, std::move(src[i]));
+        allocator_traits::destroy(m_allocator, src + i);
+      }
+    } else {
+      for (size_t i = count; i-- > 0;) {
+        allocator_traits::construct(m_allocator, dst + i, std::move(src[i]));
+        allocator_traits::destroy(m_allocator, src + i);
+      }
+    }
+  }
+
+  /* Moves the gap so that it starts at position pos of the list */
+  void move_gap(size_t pos) {
+    if (gap_size() == 0) {
+      // no elements need to move, an empty gap can start anywhere
+      m_gap_start = m_gap_end = pos;
+    } else if (pos < m_gap_start) {
+      // elements in [pos, gap_start) go to the end of the gap
+      size_t count = m_gap_start - pos;
+      relocate(m_data + m_gap_end - count, m_data + pos, count);
+      m_gap_start -= count;
+      m_gap_end -= count;
+    } else if (pos > m_gap_start) {
+      // elements following the gap go to its start
+      size_t count = pos - m_gap_start;
+      relocate(m_data + m_gap_start, m_data + m_gap_end, count);
+      m_gap_start += count;
+      m_gap_end += count;
+    }
+  }
+
+  /* Doubles capacity, the gap absorbs the new space */
+  void expand() {
+    size_t new_capacity = std::max(m_capacity * 2, k_default_capacity);
+    T *new_data = allocate(new_capacity);
+    size_t after = m_capacity - m_gap_end;
+    size_t new_gap_end = new_capacity - after;
+    std::uninitialized_move(m_data, m_data + m_gap_start, new_data);
+    std::uninitialized_move(m_data + m_gap_end, m_data + m_capacity,
+                            new_data + new_gap_end);
+    destroy_elements();
+    deallocate();
+    m_capacity = new_capacity;
+    m_gap_end = new_gap_end;
+    m_data = new_data;
+  }
+
+public:
+  /* Return the number of elements the list can hold without expanding. */
+  inline size_t capacity() const { return m_capacity; }
+
+  /* Constructs element at current position from params, after moving the
+   * gap there. Expands if necessary. */
+  template <class... R>
+  requires std::constructible_from<T, R...>
+  void emplace(R &&...params) {
+    CHECK_STATE();
+
+    if (m_gap_start != m_pos || gap_size() == 0) {
+      // params may refer to an element of this list, so construct before
+      // moving elements
+      T item(std::forward<R>(params)...);
+      if (gap_size() == 0) {
+        expand();
+      }
+      move_gap(m_pos);
+      allocator_traits::construct(m_allocator, m_data + m_gap_end - 1,
+                                  std::move(item));
+    } else {
+      allocator_traits::construct(m_allocator, m_data + m_gap_end - 1,
+                                  std::forward<R>(params)...);
+    }
+    // new element is the first one after the gap
+    m_gap_end--;
+  }
+
+  /* Constructs element at the end of the list from params, after moving the
+   * gap there. Expands if necessary. */
+  template <class... R>
+  requires std::constructible_from<T, R...>
+  void emplace_back(R &&...params) {
+    CHECK_STATE();
+
+    if (m_gap_end != m_capacity || gap_size() == 0) {
+      T item(std::forward<R>(params)...);
+      if (gap_size() == 0) {
+        expand();
+      }
+      move_gap(length());
+      allocator_traits::construct(m_allocator, m_data + m_gap_start,
+                                  std::move(item));
+    } else {
+      allocator_traits::construct(m_allocator, m_data + m_gap_start,
+                                  std::forward<R>(params)...);
+    }
+    m_gap_start++;
+  }
+
+  /* List interface implementation */
+
+  /* Clears list, destroying all elements. Leaves capacity unchanged. */
+  void clear() override {
+    CHECK_STATE();
+
+    destroy_elements();
+    m_gap_start = m_pos = 0;
+    m_gap_end = m_capacity;
+  }
+
+  /* Inserts copy of element at current position. */
+  void insert(const T &item) override { emplace(item); }
+
+  /* Inserts element at current position by moving it. */
+  void insert(T &&item) override { emplace(std::move(item)); }
+
+  /* Appends copy of element at the end of the list. */
+  void append(const T &item) override { emplace_back(item); }
+
+  /* Appends element at the end of the list by moving it. */
+  void append(T &&item) override { emplace_back(std::move(item)); }
+
+  /* Remove element at current position and return it. The gap is moved to
+   * the current position and absorbs the element. */
+  T remove() override {
+    CHECK_STATE();
+
+    if (length() == 0) {
+      throw std::runtime_error("Attempt to remove from an empty list.");
+    }
+    move_gap(m_pos);
+    T ret = std::move(m_data[m_gap_end]);
+    allocator_traits::destroy(m_allocator, m_data + m_gap_end);
+    m_gap_end++;
+    if (m_pos == length() && m_pos > 0) {
+      m_pos--;
+    }
+    return ret;
+  }
+
+  /* Set the current position at the start of the list. */
+  inline void moveToStart() override {
+    CHECK_STATE();
+    m_pos = 0;
+  }
+
+  /* Set the current position at the end of the list. */
+  inline void moveToEnd() override {
+    CHECK_STATE();
+    if (length() > 0) {
+      m_pos = length() - 1;
+    }
+  }
+
+  /* Move the current position one step left unless already at the beginning. */
+  inline void prev() override {
+    CHECK_STATE();
+    if (m_pos > 0) {
+      m_pos--;
+    }
+  }
+
+  /* Move the current position one step right unless already at the end. */
+  inline void next() override {
+    CHECK_STATE();
+    if (m_pos + 1 < length()) {
+      m_pos++;
+    }
+  }
+
+  /* Return the number of items in the list. */
+  inline size_t length() const override { return m_capacity - gap_size(); }
+
+  /* Return the current position of the list. */
+  inline size_t currPos() const override {
+    CHECK_STATE();
+    return m_pos;
+  }
+
+  /* Set current position, does not move the gap. */
+  inline void moveToPos(size_t pos) override {
+    CHECK_STATE();
+    if (pos >= length()) {
+      throw std::runtime_error(
+          "Attempt to move to position beyond the length of the list.");
+    }
+    m_pos = pos;
+  }
+
+  /* Return the value of the current element */
+  inline const T &getValue() const override {
+    CHECK_STATE();
+    if (length() == 0) {
+      throw std::runtime_error("Attempting to access element from empty list.");
+    }
+    return m_data[physical(m_pos)];
+  }
+
+  /* Search for an item in the list, returns npos ( (size_t) -1 ) if not found.
+   */
+  size_t Search(const T &item) const override {
+    size_t i = simd::find(m_data, m_gap_start, item);
+    if (i < m_gap_start) {
+      return i;
+    }
+    size_t after = m_capacity - m_gap_end;
+    size_t j = simd::find(m_data + m_gap_end, after, item);
+    return j < after ? m_gap_start + j : npos;
+  }
+
+  /* Forward iterator over the elements, does not move the current position
+   * or the gap */
+  template <bool Const> class basic_iterator {
+    friend class GapBufferList;
+    friend class basic_iterator<!Const>;
+
+    using list_ptr =
+        std::conditional_t<Const, const GapBufferList *, GapBufferList *>;
+
+    list_ptr m_list = nullptr;
+    size_t m_index = 0;
+
+    basic_iterator(list_ptr list, size_t index)
+        : m_list(list), m_index(index) {}
+
+  public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = T;
+    using difference_type = std::ptrdiff_t;
+    using pointer = std::conditional_t<Const, const T *, T *>;
+    using reference = std::conditional_t<Const, const T &, T &>;
+
+    basic_iterator() = default;
+
+    /* Mutable iterators convert to const iterators */
+    template <bool C>
+    requires(Const && !C) //
+    basic_iterator(const basic_iterator<C> &other)
+        : m_list(other.m_list), m_index(other.m_index) {}
+
+    reference operator*() const {
+      return m_list->m_data[m_list->physical(m_index)];
+    }
+    pointer operator->() const { return &**this; }
+
+    basic_iterator &operator++() {
+      m_index++;
+      return *this;
+    }
+
+    basic_iterator operator++(int) {
+      basic_iterator ret = *this;
+      m_index++;
+      return ret;
+    }
+
+    bool operator==(const basic_iterator &other) const {
+      return m_index == other.m_index;
+    }
+  };
+
+  using iterator = basic_iterator<false>;
+  using const_iterator = basic_iterator<true>;
+
+  inline iterator begin() { return iterator(this, 0); }
+  inline iterator end() { return iterator(this, length()); }
+  inline const_iterator begin() const { return const_iterator(this, 0); }
+  inline const_iterator end() const { return const_iterator(this, length()); }
+  inline const_iterator cbegin() const { return begin(); }
+  inline const_iterator cend() const { return end(); }
+
+#undef CHECK_STATE
+};
+
+} // namespace cse204
@@ -0,0 +1,573 @@
+#pragma once
+
+#include <cassert>
+#include <concepts>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+
+#include "list.h"
+
+namespace cse204 {
+
+/* Skip list ordered by position instead of by value. Every link stores how
+ * many elements it skips, so the node at any position can be found by
+ * descending from the highest level in O(log n) expected steps. Seeking,
+ * inserting and removing at any position are all O(log n), moving to the
+ * next or previous element is O(1). */
+template <class T, class Allocator = std::allocator<T>>
+class IndexedSkipList final : public List<T> {
+
+  using typename List<T>::size_t;
+  using List<T>::npos;
+
+  /* Enough levels for any list that fits in memory, since each level holds a
+   * quarter of the nodes of the level below */
+  static constexpr unsigned k_max_height = 32;
+
+  struct node;
+
+  /* Link to the next node of a level, width is the difference of their
+   * positions. The last link of a level extends past the end of the list. */
+  struct link {
+    node *next = nullptr;
+    size_t width = 0;
+  };
+
+  struct node {
+    /* not constructed for the head sentinel */
+    union {
+      T item;
+    };
+    node *prev = nullptr;
+    /* links of levels 1 to height - 1, nullptr for nodes of height 1 */
+    link *upper = nullptr;
+    link base;
+    unsigned height;
+
+    /* Constructor to create sentinel node */
+    node(unsigned height) : height(height) {}
+    /* Constructor to create node with the item to contain */
+    template <class... R>
+    requires std::constructible_from<T, R...> //
+    node(unsigned height, R &&...params)
+        : item(std::forward<R>(params)...), height(height) {}
+    /* item is destroyed explicitly, since the head does not have one */
+    ~node() {}
+
+    inline link &level(unsigned i) { return i ? upper[i - 1] : base; }
+  };
+
+  using allocator_type =
+      typename std::allocator_traits<Allocator>::template rebind_alloc<node>;
+  using allocator_traits =
+      typename std::allocator_traits<Allocator>::template rebind_traits<node>;
+  using link_allocator_type =
+      typename std::allocator_traits<Allocator>::template rebind_alloc<link>;
+  using link_allocator_traits =
+      typename std::allocator_traits<Allocator>::template rebind_traits<link>;
+
+  allocator_type m_allocator;
+  link_allocator_type m_link_allocator;
+
+  /* Sentinel node at position -1, with every level */
+  node *m_head;
+  /* node of the current element, m_head if list is empty */
+  node *m_curr;
+  /* number of levels in use */
+  unsigned m_height;
+
+  size_t m_length;
+  size_t m_pos;
+
+  /* state of the generator of node heights */
+  std::uint64_t m_random;
+
+/* Run some assertions to check validity of state. */
+#define CHECK_STATE()                                                          \
+  assert(m_head && m_curr);                                                    \
+  assert(m_height >= 1 && m_height <= k_max_height);                           \
+  if (m_length == 0) {                                                         \
+    assert(m_curr == m_head);                                                  \
+    assert(m_pos == 0);                                                        \
+    assert(m_head->base.next == nullptr);                                      \
+  } else {                                                                     \
+    assert(m_curr != m_head);                                                  \
+    assert(m_pos < m_length);                                                  \
+  }
+
+public:
+  /* Create empty list. */
+  IndexedSkipList()
+      : m_head(create_node(k_max_height)), m_curr(m_head), m_height(1),
+        m_length(0), m_pos(0), m_random(0x9e3779b97f4a7c15) {
+    m_head->base.width = 1;
+  }
+
+  /* Create list from initialiser list */
+  IndexedSkipList(std::initializer_list<T> items)
+      : IndexedSkipList(items.size(), items.begin()) {}
+
+  /* Create list with data from static array */
+  template <size_t N>
+  IndexedSkipList(T const (&items)[N]) : IndexedSkipList(N, items) {}
+
+  /* Create list with pointer data */
+  IndexedSkipList(size_t num_items, T const *items) : IndexedSkipList() {
+    for (size_t i = 0; i < num_items; i++) {
+      append(items[i]);
+    }
+    CHECK_STATE();
+  }
+
+  /* Copy constructor: copies elements from another list */
+  IndexedSkipList(const IndexedSkipList &other) requires std::copyable<T>
+      : IndexedSkipList() {
+    copy_from(other);
+    CHECK_STATE();
+  }
+
+  /* Move constructor: steals elements from another list */
+  IndexedSkipList(IndexedSkipList &&other)
+      : m_allocator(std::move(other.m_allocator)),
+        m_link_allocator(std::move(other.m_link_allocator)),
+        m_head(other.m_head), m_curr(other.m_curr), m_height(other.m_height),
+        m_length(other.m_length), m_pos(other.m_pos),
+        m_random(other.m_random) {
+    /* Reset moved from list to initial empty list */
+    other.m_curr = other.m_head = other.create_node(k_max_height);
+    other.m_head->base.width = 1;
+    other.m_height = 1;
+    other.m_length = other.m_pos = 0;
+    CHECK_STATE();
+  }
+
+  /* Copy assignment: copies elements from another list */
+  IndexedSkipList &operator=(const IndexedSkipList &other)
+    requires std::copyable<T>
+  {
+    if (this == &other) {
+      return *this;
+    }
+    clear();
+    copy_from(other);
+    CHECK_STATE();
+    return *this;
+  }
+
+  /* Move assignment: steals elements from another list */
+  IndexedSkipList &operator=(IndexedSkipList &&other) {
+    if (this == &other) {
+      return *this;
+    }
+    // the cleared head is handed over to the other list, along with the
+    // allocators that own it
+    clear();
+    std::swap(m_allocator, other.m_allocator);
+    std::swap(m_link_allocator, other.m_link_allocator);
+    std::swap(m_head, other.m_head);
+    std::swap(m_curr, other.m_curr);
+    std::swap(m_height, other.m_height);
+    std::swap(m_length, other.m_length);
+    std::swap(m_pos, other.m_pos);
+    CHECK_STATE();
+    return *this;
+  }
+
+  /* Destructor */
+  ~IndexedSkipList() {
+    clear();
+    delete_node(m_head);
+  }
+
+private:
+  /* helper methods */
+
+  /* allocate and construct a node of the given height from params */
+  template <class... R> node *create_node(unsigned height, R &&...params) {
+    node *p = allocator_traits::allocate(m_allocator, 1);
+    try {
+      allocator_traits::construct(m_allocator, p, height,
+                                  std::forward<R>(params)...);
+    } catch (...) {
+      allocator_traits::deallocate(m_allocator, p, 1);
+      throw;
+    }
+    if (height > 1) {
+      try {
+        p->upper = link_allocator_traits::allocate(m_link_allocator,
+                                                   height - 1);
+      } catch (...) {
+        // the node is constructed by now, upper is still nullptr
+        if constexpr (sizeof...(R) > 0) {
+          delete_element(p);
+        } else {
+          delete_node(p);
+        }
+        throw;
+      }
+      std::uninitialized_fill_n(p->upper, height - 1, link{});
+    }
+    return p;
+  }
+
+  /* destroy and deallocate a node, whose item is already destroyed */
+  void delete_node(node *p) {
+    if (p->upper) {
+      link_allocator_traits::deallocate(m_link_allocator, p->upper,
+                                        p->height - 1);
+    }
+    allocator_traits::destroy(m_allocator, p);
+    allocator_traits::deallocate(m_allocator, p, 1);
+  }
+
+  /* destroy the item of a node, then delete it */
+  void delete_element(node *p) {
+    allocator_traits::destroy(m_allocator, &p->item);
+    delete_node(p);
+  }
+
+  /* Height of a new node, each level is reached with probability 1/4 */
+  unsigned random_height() {
+    // xorshift64
+    m_random ^= m_random << 13;
+    m_random ^= m_random >> 7;
+    m_random ^= m_random << 17;
+    std::uint64_t bits = m_random;
+    unsigned height = 1;
+    while (height < k_max_height && (bits & 3) == 0) {
+      height++;
+      bits >>= 2;
+    }
+    return height;
+  }
+
+  /* Fills update with the last node before the element at position pos at
+   * every level in use, and ranks with their positions plus one */
+  void find_predecessors(size_t pos, node **update, size_t *ranks) {
+    node *x = m_head;
+    size_t rank = 0;
+    for (unsigned i = m_height; i-- > 0;) {
+      while (x->level(i).next && rank + x->level(i).width <= pos) {
+        rank += x->level(i).width;
+        x = x->level(i).next;
+      }
+      update[i] = x;
+      ranks[i] = rank;
+    }
+  }
+
+  /* Returns the node of the element at position pos */
+  node *seek(size_t pos) const {
+    node *x = m_head;
+    size_t rank = 0;
+    for (unsigned i = m_height; i-- > 0;) {
+      while (x->level(i).next && rank + x->level(i).width <= pos + 1) {
+        rank += x->level(i).width;
+        x = x->level(i).next;
+      }
+      if (rank == pos + 1) {
+        break;
+      }
+    }
+    assert(x != m_head);
+    return x;
+  }
+
+  /* Links node p into the list at position pos */
+  void link_at(size_t pos, node *p) {
+    node *update[k_max_height];
+    size_t ranks[k_max_height];
+
+    // levels that come into use span the whole list from the head
+    for (; m_height < p->height; m_height++) {
+      m_head->level(m_height) = {nullptr, m_length + 1};
+    }
+    find_predecessors(pos, update, ranks);
+
+    size_t rank = pos + 1;
+    for (unsigned i = 0; i < m_height; i++) {
+      link &u = update[i]->level(i);
+      if (i < p->height) {
+        // the old link is split in two by the new node, and grows by one
+        p->level(i) = {u.next, u.width + ranks[i] + 1 - rank};
+        u = {p, rank - ranks[i]};
+      } else {
+        u.width++;
+      }
+    }
+    p->prev = update[0];
+    if (p->base.next) {
+      p->base.next->prev = p;
+    }
+    m_length++;
+  }
+
+  /* Unlinks the node of the element at position pos and returns it */
+  node *unlink_at(size_t pos) {
+    node *update[k_max_height];
+    size_t ranks[k_max_height];
+    find_predecessors(pos, update, ranks);
+
+    node *p = update[0]->base.next;
+    assert(p);
+    for (unsigned i = 0; i < m_height; i++) {
+      link &u = update[i]->level(i);
+      if (u.next == p) {
+        u = {p->level(i).next, u.width + p->level(i).width - 1};
+      } else {
+        u.width--;
+      }
+    }
+    if (p->base.next) {
+      p->base.next->prev = p->prev;
+    }
+    // stop searching levels that have become empty
+    while (m_height > 1 && !m_head->level(m_height - 1).next) {
+      m_height--;
+    }
+    m_length--;
+    return p;
+  }
+
+  /* Appends copies of elements of other list, which must be empty */
+  void copy_from(const IndexedSkipList &other) {
+    for (const T &item : other) {
+      append(item);
+    }
+    if (m_length > 0) {
+      moveToPos(other.m_pos);
+    }
+  }
+
+public:
+  /* Construct an item from params at the current location of the list. */
+  template <class... R>
+  requires std::constructible_from<T, R...>
+  void emplace(R &&...params) {
+    CHECK_STATE();
+
+    node *p = create_node(random_height(), std::forward<R>(params)...);
+    link_at(m_pos, p);
+    m_curr = p;
+
+    CHECK_STATE();
+  }
+
+  /* Construct an item from params at the end of list. */
+  template <class... R>
+  requires std::constructible_from<T, R...>
+  void emplace_back(R &&...params) {
+    CHECK_STATE();
+
+    node *p = create_node(random_height(), std::forward<R>(params)...);
+    link_at(m_length, p);
+    if (m_length == 1) {
+      m_curr = p;
+    }
+
+    CHECK_STATE();
+  }
+
+  /* List interface implementation */
+
+  /* Clear contents from the list, to make it empty. */
+  void clear() override {
+    CHECK_STATE();
+
+    node *p = m_head->base.next;
+    while (p) {
+      node *t = p;
+      p = p->base.next;
+      delete_element(t);
+    }
+    for (unsigned i = 0; i < m_height; i++) {
+      m_head->level(i) = {nullptr, 1};
+    }
+    m_height = 1;
+    m_curr = m_head;
+    m_pos = m_length = 0;
+  }
+
+  /* Insert an element at the current location. */
+  void insert(const T &item) override { emplace(item); }
+
+  /* Insert an element at the current location by moving it. */
+  void insert(T &&item) override { emplace(std::move(item)); }
+
+  /* Append an element at the end of the list. */
+  void append(const T &item) override { emplace_back(item); }
+
+  /* Append an element at the end of the list by moving it. */
+  void append(T &&item) override { emplace_back(std::move(item)); }
+
+  /* Remove and return the current element. */
+  T remove() override {
+    CHECK_STATE();
+
+    if (m_length == 0) {
+      throw std::runtime_error("Attempt to remove from an empty list.");
+    }
+
+    node *p = unlink_at(m_pos);
+    assert(p == m_curr);
+    if (p->base.next) {
+      m_curr = p->base.next;
+    } else if (m_length > 0) {
+      // removed the last element, current is the new last element
+      m_curr = p->prev;
+      m_pos--;
+    } else {
+      m_curr = m_head;
+    }
+
+    T ret = std::move(p->item);
+    delete_element(p);
+
+    CHECK_STATE();
+    return ret;
+  }
+
+  /* Set the current position to the start of the list */
+  inline void moveToStart() override {
+    CHECK_STATE();
+    if (m_length > 0) {
+      m_curr = m_head->base.next;
+      m_pos = 0;
+    }
+  }
+
+  /* Set the current position to the end of the list */
+  inline void moveToEnd() override {
+    CHECK_STATE();
+    if (m_length > 0) {
+      m_curr = seek(m_length - 1);
+      m_pos = m_length - 1;
+    }
+  }
+
+  /* Move the current position one step left. No change if already at
+   * beginning. */
+  inline void prev() override {
+    CHECK_STATE();
+    if (m_pos > 0) {
+      m_curr = m_curr->prev;
+      m_pos--;
+    }
+  }
+
+  /* Move the current position one step right. No change if already at end. */
+  inline void next() override {
+    CHECK_STATE();
+    if (m_pos + 1 < m_length) {
+      m_curr = m_curr->base.next;
+      m_pos++;
+    }
+  }
+
+  /* Return the number of elements in the list. */
+  inline size_t length() const override {
+    CHECK_STATE();
+    return m_length;
+  }
+
+  /* Return the position of the current element. */
+  inline size_t currPos() const override {
+    CHECK_STATE();
+    return m_pos;
+  }
+
+  /* Set current position, descending the levels from the head. */
+  void moveToPos(size_t pos) override {
+    CHECK_STATE();
+
+    if (pos >= m_length) {
+      throw std::runtime_error(
+          "Attempt to move to position beyond the length of the list.");
+    }
+    m_curr = seek(pos);
+    m_pos = pos;
+  }
+
+  /* Return the current element. */
+  inline const T &getValue() const override {
+    CHECK_STATE();
+    if (m_length == 0) {
+      throw std::runtime_error(
+          "Attempt to get value of element from empty list.");
+    }
+    return m_curr->item;
+  }
+
+  /* Search for an item in the list, returns npos ( (size_t) -1 ) if not found.
+   */
+  size_t Search(const T &item) const override {
+    size_t i = 0;
+    for (node *p = m_head->base.next; p; p = p->base.next, i++) {
+      if (p->item == item) {
+        return i;
+      }
+    }
+    return npos;
+  }
+
+  /* Forward iterator over the elements, does not move the current position */
+  template <bool Const> class basic_iterator {
+    friend class IndexedSkipList;
+    friend class basic_iterator<!Const>;
+
+    using node_ptr = std::conditional_t<Const, const node *, node *>;
+
+    node_ptr m_node = nullptr;
+
+    explicit basic_iterator(node_ptr p) : m_node(p) {}
+
+  public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = T;
+    using difference_type = std::ptrdiff_t;
+    using pointer = std::conditional_t<Const, const T *, T *>;
+    using reference = std::conditional_t<Const, const T &, T &>;
+
+    basic_iterator() = default;
+
+    /* Mutable iterators convert to const iterators */
+    template <bool C>
+    requires(Const && !C) //
+    basic_iterator(const basic_iterator<C> &other) : m_node(other.m_node) {}
+
+    reference operator*() const { return m_node->item; }
+    pointer operator->() const { return &m_node->item; }
+
+    basic_iterator &operator++() {
+      m_node = m_node->base.next;
+      return *this;
+    }
+
+    basic_iterator operator++(int) {
+      basic_iterator ret = *this;
+      m_node = m_node->base.next;
+      return ret;
+    }
+
+    bool operator==(const basic_iterator &other) const = default;
+  };
+
+  using iterator = basic_iterator<false>;
+  using const_iterator = basic_iterator<true>;
+
+  inline iterator begin() { return iterator(m_head->base.next); }
+  inline iterator end() { return iterator(); }
+  inline const_iterator begin() const {
+    return const_iterator(m_head->base.next);
+  }
+  inline const_iterator end() const { return const_iterator(); }
+  inline const_iterator cbegin() const { return begin(); }
+  inline const_iterator cend() const { return end(); }
+
+#undef CHECK_STATE
+};
+
+} // namespace cse204
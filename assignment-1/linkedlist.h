@@ -2,12 +2,20 @@
 
 #include <algorithm>
 #include <cassert>
+#include <concepts>
+#include <iterator>
+#include <ranges>
+#include <stdexcept>
+#include <type_traits>
 
 #include "list.h"
+#include "pool_allocator.h"
+#include "serialization.h"
 
 namespace cse204 {
 
-template <typename T> class LinkedList : public List<T> {
+template <class T, class Allocator = std::allocator<T>>
+class LinkedList final : public List<T> {
 
   using typename List<T>::size_t;
   using List<T>::npos;
@@ -15,12 +23,23 @@ template <typename T> class LinkedList : public List<T> {
   struct node {
     T item;
     node *next;
+    node *prev;
     /* Constructor to create sentinel node */
-    node(node *next) : item{}, next(next) {}
+    node(node *next) : item{}, next(next), prev(nullptr) {}
     /* Constructor to create node with the item to contain */
-    node(const T &item, node *next = nullptr) : item(item), next(next) {}
+    template <class... R>
+    requires std::constructible_from<T, R...> //
+    node(node *prev, node *next, R &&...params)
+        : item(std::forward<R>(params)...), next(next), prev(prev) {}
   };
 
+  using allocator_type =
+      typename std::allocator_traits<Allocator>::template rebind_alloc<node>;
+  using allocator_traits =
+      typename std::allocator_traits<Allocator>::template rebind_traits<node>;
+
+  allocator_type m_allocator;
+
   /* Sentinel node, to indicate the start of the list. First actual node is
    * m_head->next. */
   node *m_head;
@@ -47,6 +66,7 @@ template <typename T> class LinkedList : public List<T> {
   }                                                                            \
   if (m_length > 0) {                                                          \
     assert(m_curr && m_curr->next);                                            \
+    assert(m_curr->next->prev == m_curr);                                      \
     assert(m_head->next);                                                      \
     assert(m_tail->next);                                                      \
     assert(m_tail->next->next == nullptr);                                     \
@@ -56,7 +76,7 @@ template <typename T> class LinkedList : public List<T> {
 public:
   /* Create empty list. */
   LinkedList()
-      : m_head(new node(nullptr)), m_tail(m_head), m_curr(m_head), m_length(0),
+      : m_head(create_node(nullptr)), m_tail(m_head), m_curr(m_head), m_length(0),
         m_pos(0) {
     CHECK_STATE();
   }
@@ -85,17 +105,18 @@ public:
   }
 
   /* Copy construct: copies elements from another list */
-  LinkedList(const LinkedList<T> &other) : m_head(new node(nullptr)) {
+  LinkedList(const LinkedList &other) : m_head(create_node(nullptr)) {
     copy_from(other);
     CHECK_STATE();
   }
 
   /* Move constructor: steals elements from another list */
-  LinkedList(LinkedList<T> &&other)
-      : m_head(other.m_head), m_tail(other.m_tail), m_curr(other.m_curr),
-        m_length(other.m_length), m_pos(other.m_pos) {
+  LinkedList(LinkedList &&other)
+      : m_allocator(std::move(other.m_allocator)), m_head(other.m_head),
+        m_tail(other.m_tail), m_curr(other.m_curr), m_length(other.m_length),
+        m_pos(other.m_pos) {
     /* Reset moved from linkedlist to initial empty list */
-    other.m_curr = other.m_tail = other.m_head = new node(nullptr);
+    other.m_curr = other.m_tail = other.m_head = other.create_node(nullptr);
     other.m_length = other.m_pos = 0;
     CHECK_STATE();
   }
@@ -114,14 +135,16 @@ public:
   }
 
   /* Move assignment: steal elements from another list */
-  LinkedList<T> &operator=(LinkedList<T> &&other) {
+  LinkedList &operator=(LinkedList &&other) {
     if (this == &other) {
       // to handle self-assignment
       return *this;
     }
     // delete current elements and steal everything from other list
     delete_elements();
-    // swap the head sentinel nodes as well
+    // swap the head sentinel nodes as well, along with the allocators that
+    // own them
+    std::swap(m_allocator, other.m_allocator);
     std::swap(m_head, other.m_head);
     m_tail = other.m_tail;
     m_curr = other.m_curr;
@@ -139,25 +162,71 @@ public:
   /* Destructor */
   ~LinkedList() {
     delete_elements();
-    delete m_head;
+    delete_node(m_head);
   }
 
 private:
   /* helper methods */
 
+  /* allocate and construct a node from params */
+  template <class... R> node *create_node(R &&...params) {
+    node *p = allocator_traits::allocate(m_allocator, 1);
+    allocator_traits::construct(m_allocator, p, std::forward<R>(params)...);
+    return p;
+  }
+
+  /* destroy and deallocate a node */
+  void delete_node(node *p) {
+    allocator_traits::destroy(m_allocator, p);
+    allocator_traits::deallocate(m_allocator, p, 1);
+  }
+
+  /* Nodes linked to each other, but not yet to the list */
+  struct chain {
+    node *first = nullptr;
+    node *last = nullptr;
+    size_t length = 0;
+  };
+
+  /* create a chain of nodes holding the elements of [first, last) */
+  template <class I, class S> chain create_chain(I first, S last) {
+    chain c;
+    for (; first != last; ++first) {
+      node *p = create_node(c.last, nullptr, *first);
+      if (c.last) {
+        c.last->next = p;
+      } else {
+        c.first = p;
+      }
+      c.last = p;
+      c.length++;
+    }
+    return c;
+  }
+
+  /* link a non-empty chain into the list after node p */
+  void splice_after(node *p, const chain &c) {
+    c.first->prev = p;
+    c.last->next = p->next;
+    if (p->next) {
+      p->next->prev = c.last;
+    }
+    p->next = c.first;
+  }
+
   /* delete all the nodes in the list, except the head */
   void delete_elements() {
     node *p = m_head->next;
     while (p) {
       node *t = p;
       p = p->next;
-      delete t;
+      delete_node(t);
     }
   }
 
   /* Assuming the list is cleared and do not have dangling resources, copy
    * elements from other list */
-  void copy_from(const LinkedList<T> &other) {
+  void copy_from(const LinkedList &other) {
     m_pos = other.m_pos;
     m_length = other.m_length;
     // assume the other list may be empty at this point
@@ -184,7 +253,7 @@ private:
       }
 
       old_node = old_node->next;
-      new_node->next = new node(old_node->item);
+      new_node->next = create_node(new_node, nullptr, old_node->item);
       new_node = new_node->next;
 
       i++;
@@ -201,7 +270,18 @@ public:
   void clear() override {
     CHECK_STATE();
 
-    delete_elements();
+    if constexpr (ReleasableAllocator<allocator_type>) {
+      // destroy every node including the head, then free their memory at once
+      for (node *p = m_head; p;) {
+        node *t = p;
+        p = p->next;
+        allocator_traits::destroy(m_allocator, t);
+      }
+      m_allocator.release();
+      m_head = create_node(nullptr);
+    } else {
+      delete_elements();
+    }
     // reset everything
     m_head->next = nullptr;
     m_curr = m_tail = m_head;
@@ -209,12 +289,17 @@ public:
     m_pos = m_length = 0;
   }
 
-  /* Insert an item at the current location of the list. */
-  void insert(const T &item) override {
+  /* Construct an item from params at the current location of the list. */
+  template <class... R>
+  requires std::constructible_from<T, R...>
+  void emplace(R &&...params) {
     CHECK_STATE();
 
-    node *new_node = new node(item);
-    new_node->next = m_curr->next;
+    node *new_node =
+        create_node(m_curr, m_curr->next, std::forward<R>(params)...);
+    if (m_curr->next) {
+      m_curr->next->prev = new_node;
+    }
     m_curr->next = new_node;
     // if current element was the second most element, now the new node is
     if (m_tail == m_curr) {
@@ -226,12 +311,15 @@ public:
     m_length++;
   }
 
-  /* Append an item at the end of list. */
-  void append(const T &item) override {
+  /* Construct an item from params at the end of list. */
+  template <class... R>
+  requires std::constructible_from<T, R...>
+  void emplace_back(R &&...params) {
     CHECK_STATE();
 
-    node *new_node = new node(item, nullptr);
     // if list is not empty, it will have one node after tail
+    node *last = m_tail->next ? m_tail->next : m_head;
+    node *new_node = create_node(last, nullptr, std::forward<R>(params)...);
     if (m_tail->next) {
       assert(m_length > 0);
       m_tail->next->next = new_node;
@@ -245,6 +333,103 @@ public:
     m_length++;
   }
 
+  /* Insert a copy of item at the current location of the list. */
+  void insert(const T &item) override { emplace(item); }
+
+  /* Insert an item at the current location of the list by moving it. */
+  void insert(T &&item) override { emplace(std::move(item)); }
+
+  /* Append a copy of item at the end of list. */
+  void append(const T &item) override { emplace_back(item); }
+
+  /* Append an item at the end of list by moving it. */
+  void append(T &&item) override { emplace_back(std::move(item)); }
+
+  /* Insert the elements of [first, last) at the current location of the list
+   * with a single splice. The current position is at the first inserted
+   * element afterwards. */
+  template <std::input_iterator I>
+  requires std::constructible_from<T, std::iter_reference_t<I>>
+  void insert(I first, I last) {
+    CHECK_STATE();
+
+    chain c = create_chain(first, last);
+    if (c.length == 0) {
+      return;
+    }
+    splice_after(m_curr, c);
+    if (m_length == 0) {
+      // chain is the whole list
+      m_tail = c.length > 1 ? c.last->prev : m_head;
+    } else if (m_curr == m_tail) {
+      // chain went in right before the last node
+      m_tail = c.last;
+    }
+    m_length += c.length;
+  }
+
+  /* Append every element of range at the end of the list with a single
+   * splice. */
+  template <std::ranges::input_range R>
+  requires(!std::convertible_to<R, T>) &&
+      std::constructible_from<T, std::ranges::range_reference_t<R>>
+  void append(R &&range) {
+    CHECK_STATE();
+
+    chain c = create_chain(std::ranges::begin(range), std::ranges::end(range));
+    if (c.length == 0) {
+      return;
+    }
+    // if list is not empty, it will have one node after tail
+    splice_after(m_tail->next ? m_tail->next : m_head, c);
+    m_length += c.length;
+    m_tail = m_length > 1 ? c.last->prev : m_head;
+  }
+
+  /* Remove count items starting from the current location, unlinking them
+   * with a single splice. */
+  void remove(size_t count) {
+    CHECK_STATE();
+
+    if (count > m_length - m_pos) {
+      throw std::runtime_error("Attempt to remove beyond the end of the list.");
+    }
+    if (count == 0) {
+      return;
+    }
+    node *first = m_curr->next;
+    node *last = first;
+    bool removes_tail = first == m_tail;
+    for (size_t i = 1; i < count; i++) {
+      last = last->next;
+      removes_tail = removes_tail || last == m_tail;
+    }
+
+    m_curr->next = last->next;
+    if (last->next) {
+      last->next->prev = m_curr;
+    }
+    m_length -= count;
+
+    if (m_length == 0) {
+      assert(m_curr == m_head);
+      m_tail = m_head;
+    } else if (m_curr->next == nullptr) {
+      // removed everything up to the end, have to shift back
+      m_tail = m_curr = m_curr->prev;
+      m_pos--;
+    } else if (removes_tail) {
+      // [curr] -> [removed ... tail (x)] -> [last node] -> null
+      m_tail = m_curr;
+    }
+
+    for (node *p = first, *end = last->next; p != end;) {
+      node *t = p;
+      p = p->next;
+      delete_node(t);
+    }
+  }
+
   /* Remove the current item and return the value. */
   T remove() override {
     CHECK_STATE();
@@ -257,22 +442,19 @@ public:
     assert(m_curr->next);
     /* The node to remove is the node after m_curr. */
     node *del_node = m_curr->next;
-    T del_val = del_node->item;
+    T del_val = std::move(del_node->item);
 
     m_curr->next = del_node->next;
-
-    delete del_node;
+    if (del_node->next) {
+      del_node->next->prev = m_curr;
+    }
 
     if (m_length > 1) {
       // the edge cases: tail being deleted or the need to shift back can only
       // happen if length > 1, because otherwise head == tail == curr anyway.
       if (m_curr == m_tail) {
         // deleted the one node after tail, have to shift back
-        node *p = m_head;
-        while (p->next != m_curr) {
-          p = p->next;
-        }
-        m_tail = m_curr = p;
+        m_tail = m_curr = m_curr->prev;
         m_pos--;
       } else if (del_node == m_tail) {
         // [curr] -> [tail (x)] -> [last node] -> null
@@ -281,6 +463,7 @@ public:
       }
     }
 
+    delete_node(del_node);
     m_length--;
     return del_val;
   }
@@ -307,7 +490,7 @@ public:
 
   /* Move the current position one step left, unless already at the beginning.
    */
-  void prev() override {
+  inline void prev() override {
     CHECK_STATE();
 
     if (m_curr == m_head) {
@@ -318,14 +501,7 @@ public:
     // list must not be empty if m_curr is not at the beginning
     assert(m_length > 0 && m_pos > 0);
 
-    // since its a singly linked list, have to iterate from start to get to
-    // previous node
-    node *p = m_head;
-    while (p->next != m_curr) {
-      p = p->next;
-    }
-    m_curr = p;
-
+    m_curr = m_curr->prev;
     m_pos--;
   }
 
@@ -354,7 +530,8 @@ public:
     return m_pos;
   }
 
-  /* Set current position. */
+  /* Set current position, walking from the closest of the start, the current
+   * position or the end. */
   void moveToPos(size_t pos) override {
     CHECK_STATE();
 
@@ -363,14 +540,29 @@ public:
           "Attempt to move to position beyond the length of the list.");
     }
 
-    for (m_pos = 0, m_curr = m_head; m_pos < pos;
-         m_pos++, m_curr = m_curr->next) {
+    // walk from whichever of the start, current position or end is closest
+    size_t from_curr = pos > m_pos ? pos - m_pos : m_pos - pos;
+    size_t from_end = m_length - 1 - pos;
+    if (pos <= from_curr && pos <= from_end) {
+      m_curr = m_head;
+      m_pos = 0;
+    } else if (from_end < from_curr) {
+      m_curr = m_tail;
+      m_pos = m_length - 1;
+    }
+
+    for (; m_pos < pos; m_pos++) {
+      m_curr = m_curr->next;
+      assert(m_curr);
+    }
+    for (; m_pos > pos; m_pos--) {
+      m_curr = m_curr->prev;
       assert(m_curr);
     }
   }
 
   /* Return the current element. */
-  inline T getValue() const override {
+  inline const T &getValue() const override {
     CHECK_STATE();
     // list is empty if no node follows head
     if (m_head->next == nullptr) {
@@ -399,7 +591,99 @@ public:
     return npos;
   }
 
+  /* Writes the length, the current position and then the elements to a
+   * binary stream. */
+  void serialize(std::ostream &out) const
+    requires BinarySerializable<T>
+  {
+    serialization::write_header(out, m_length, m_pos);
+    serialization::write_items(out, begin(), m_length);
+  }
+
+  /* Replaces the contents of the list with a list written by serialize. */
+  void deserialize(std::istream &in)
+    requires BinarySerializable<T>
+  {
+    auto [length, pos] = serialization::read_header(in);
+    clear();
+    serialization::read_items<T>(
+        in, length, [this](T &&item) { emplace_back(std::move(item)); });
+    if (length > 0) {
+      moveToPos(pos);
+    }
+  }
+
+  /* Check element-wise equality by walking the nodes of both lists, stops at
+   * the first difference */
+  friend bool operator==(const LinkedList &a, const LinkedList &b) {
+    if (a.m_length != b.m_length) {
+      return false;
+    }
+    for (node *p = a.m_head->next, *q = b.m_head->next; p;
+         p = p->next, q = q->next) {
+      if (!(p->item == q->item)) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  /* Forward iterator over the elements, does not move the current position */
+  template <bool Const> class basic_iterator {
+    friend class LinkedList;
+    friend class basic_iterator<!Const>;
+
+    using node_ptr = std::conditional_t<Const, const node *, node *>;
+
+    node_ptr m_node = nullptr;
+
+    explicit basic_iterator(node_ptr p) : m_node(p) {}
+
+  public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = T;
+    using difference_type = std::ptrdiff_t;
+    using pointer = std::conditional_t<Const, const T *, T *>;
+    using reference = std::conditional_t<Const, const T &, T &>;
+
+    basic_iterator() = default;
+
+    /* Mutable iterators convert to const iterators */
+    template <bool C>
+    requires(Const && !C) //
+    basic_iterator(const basic_iterator<C> &other) : m_node(other.m_node) {}
+
+    reference operator*() const { return m_node->item; }
+    pointer operator->() const { return &m_node->item; }
+
+    basic_iterator &operator++() {
+      m_node = m_node->next;
+      return *this;
+    }
+
+    basic_iterator operator++(int) {
+      basic_iterator ret = *this;
+      m_node = m_node->next;
+      return ret;
+    }
+
+    bool operator==(const basic_iterator &other) const = default;
+  };
+
+  using iterator = basic_iterator<false>;
+  using const_iterator = basic_iterator<true>;
+
+  inline iterator begin() { return iterator(m_head->next); }
+  inline iterator end() { return iterator(); }
+  inline const_iterator begin() const { return const_iterator(m_head->next); }
+  inline const_iterator end() const { return const_iterator(); }
+  inline const_iterator cbegin() const { return begin(); }
+  inline const_iterator cend() const { return end(); }
+
 #undef CHECK_STATE
 };
 
+/* Linked list whose nodes are carved out of slabs owned by the list */
+template <class T> using PooledLinkedList = LinkedList<T, PoolAllocator<T>>;
+
 } // namespace cse204
@@ -1,8 +1,11 @@
 #pragma once
 
+#include <algorithm>
 #include <cassert>
+#include <concepts>
 #include <cstddef>
 #include <ostream>
+#include <ranges>
 #include <sstream>
 
 namespace cse204 {
@@ -14,10 +17,14 @@ protected:
   static const size_t npos = (size_t)-1;
 
 public:
+  using value_type = T;
+
   /* List ADT methods */
   virtual void clear() = 0;
   virtual void insert(const T &item) = 0;
+  virtual void insert(T &&item) = 0;
   virtual void append(const T &item) = 0;
+  virtual void append(T &&item) = 0;
   virtual T remove() = 0;
   virtual void moveToStart() = 0;
   virtual void moveToEnd() = 0;
@@ -26,10 +33,38 @@ public:
   virtual size_t length() const = 0;
   virtual size_t currPos() const = 0;
   virtual void moveToPos(size_t pos) = 0;
-  virtual T getValue() const = 0;
+  virtual const T &getValue() const = 0;
   virtual size_t Search(const T &item) const = 0;
 };
 
+/* Compile time version of the List interface. Templates constrained on it
+ * call the methods of the concrete list type directly, so for final list
+ * classes the calls can be inlined instead of going through the vtable. */
+template <class L, class T = typename L::value_type>
+concept ListADT = requires(L list, const L const_list, const T &item,
+                           std::size_t pos) {
+  list.clear();
+  list.insert(item);
+  list.append(item);
+  { list.remove() } -> std::same_as<T>;
+  list.moveToStart();
+  list.moveToEnd();
+  list.prev();
+  list.next();
+  { const_list.length() } -> std::convertible_to<std::size_t>;
+  { const_list.currPos() } -> std::convertible_to<std::size_t>;
+  list.moveToPos(pos);
+  { const_list.getValue() } -> std::convertible_to<const T &>;
+  { const_list.Search(item) } -> std::convertible_to<std::size_t>;
+};
+
+/* List whose elements can be traversed with iterators, without using or
+ * moving the current position */
+template <class L>
+concept IterableList =
+    std::ranges::forward_range<const L> &&
+    std::derived_from<L, List<std::ranges::range_value_t<const L>>>;
+
 /* Print a list to output stream */
 template <typename T>
 std::ostream &operator<<(std::ostream &os, List<T> &list) {
@@ -63,20 +98,62 @@ template <typename T> std::string to_string(List<T> &list) {
   return oss.str();
 }
 
-/* Check element-wise equality between lists */
+/* Print an iterable list to output stream, leaves the list untouched */
+template <IterableList L>
+std::ostream &operator<<(std::ostream &os, const L &list) {
+  os << '<';
+  const size_t curr_pos = list.currPos();
+  size_t i = 0;
+  for (const auto &item : list) {
+    if (i > 0) {
+      os << ' ';
+    }
+    if (i == curr_pos) {
+      os << "| ";
+    }
+    os << item;
+    i++;
+  }
+  os << '>';
+  return os;
+}
+
+/* Print an iterable list to a string */
+template <IterableList L> std::string to_string(const L &list) {
+  std::ostringstream oss;
+  oss << list;
+  return oss.str();
+}
+
+/* Check element-wise equality between lists through their cursors, the
+ * current positions are restored before returning */
 template <typename T> bool operator==(List<T> &a, List<T> &b) {
   if (a.length() != b.length()) {
     return false;
   }
+  if (&a == &b || a.length() == 0) {
+    return true;
+  }
   size_t pos_a = a.currPos(), pos_b = b.currPos();
-  for (a.moveToStart(), b.moveToStart();; a.next(), b.next()) {
-    if (a.getValue() != b.getValue()) {
-      return false;
-    }
+  bool equal = true;
+  a.moveToStart();
+  b.moveToStart();
+  for (size_t i = 0; equal && i < a.length(); i++, a.next(), b.next()) {
+    equal = a.getValue() == b.getValue();
   }
   // Restore postion
   a.moveToPos(pos_a);
   b.moveToPos(pos_b);
-  return true;
+  return equal;
+}
+
+/* Check element-wise equality between iterable lists, leaves the lists
+ * untouched */
+template <IterableList L1, IterableList L2>
+requires std::same_as<std::ranges::range_value_t<const L1>,
+                      std::ranges::range_value_t<const L2>>
+bool operator==(const L1 &a, const L2 &b) {
+  return a.length() == b.length() &&
+         std::equal(a.begin(), a.end(), b.begin(), b.end());
 }
 } // namespace cse204
@@ -0,0 +1,459 @@
+#pragma once
+
+#include <cassert>
+#include <concepts>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "list.h"
+
+namespace cse204 {
+
+/* List whose copies share their elements. The elements are kept in a treap
+ * ordered by position, every node knowing the size of its subtree, so any
+ * position is found in O(log n) expected steps.
+ *
+ * Nodes are reference counted and never modified while shared. Copying a
+ * list only shares its root, so it is O(1). Inserting or removing copies
+ * just the nodes on the path to the position that are also used by another
+ * copy, O(log n) of them, and leaves every other copy unchanged.
+ *
+ * Reference counts are not atomic, copies must stay on a single thread.
+ * Nodes may be freed by any copy, so the allocator must always compare
+ * equal. */
+template <class T, class Allocator = std::allocator<T>>
+requires std::copyable<T> &&
+    std::allocator_traits<Allocator>::is_always_equal::value
+class PersistentList final : public List<T> {
+
+  using typename List<T>::size_t;
+  using List<T>::npos;
+
+  struct node {
+    node *left = nullptr;
+    node *right = nullptr;
+    /* number of elements in the subtree rooted at this node */
+    size_t size = 1;
+    /* number of parents and lists referring to this node */
+    size_t refs = 1;
+    /* a node has a higher priority than its children */
+    std::uint32_t priority;
+    T value;
+
+    template <class... R>
+    node(std::uint32_t priority, R &&...params)
+        : priority(priority), value(std::forward<R>(params)...) {}
+  };
+
+  using allocator_type =
+      typename std::allocator_traits<Allocator>::template rebind_alloc<node>;
+  using allocator_traits =
+      typename std::allocator_traits<Allocator>::template rebind_traits<node>;
+
+  allocator_type m_allocator;
+
+  /* root of the treap, nullptr if list is empty */
+  node *m_root;
+  size_t m_pos;
+  std::uint64_t m_random;
+
+/* Run some assertions to check validity of state. */
+#define CHECK_STATE()                                                          \
+  if (m_root) {                                                                \
+    assert(m_root->refs > 0);                                                  \
+    assert(m_pos < m_root->size);                                              \
+  } else {                                                                     \
+    assert(m_pos == 0);                                                        \
+  }
+
+public:
+  /* Create empty list. */
+  PersistentList()
+      : m_root(nullptr), m_pos(0), m_random(0x9e3779b97f4a7c15) {}
+
+  /* Create list from initialiser list */
+  PersistentList(std::initializer_list<T> items)
+      : PersistentList(items.size(), items.begin()) {}
+
+  /* Create list with data from static array */
+  template <size_t N>
+  PersistentList(T const (&items)[N]) : PersistentList(N, items) {}
+
+  /* Create list with pointer data */
+  PersistentList(size_t num_items, T const *items) : PersistentList() {
+    for (size_t i = 0; i < num_items; i++) {
+      append(items[i]);
+    }
+    CHECK_STATE();
+  }
+
+  /* Copy constructor: shares the elements of another list in O(1) */
+  PersistentList(const PersistentList &other)
+      : m_allocator(other.m_allocator), m_root(acquire(other.m_root)),
+        m_pos(other.m_pos), m_random(other.m_random) {
+    CHECK_STATE();
+  }
+
+  /* Move constructor: steals elements from another list */
+  PersistentList(PersistentList &&other)
+      : m_allocator(std::move(other.m_allocator)), m_root(other.m_root),
+        m_pos(other.m_pos), m_random(other.m_random) {
+    other.m_root = nullptr;
+    other.m_pos = 0;
+    CHECK_STATE();
+  }
+
+  /* Copy assignment: shares the elements of another list in O(1) */
+  PersistentList &operator=(const PersistentList &other) {
+    node *root = acquire(other.m_root);
+    release(m_root);
+    m_root = root;
+    m_pos = other.m_pos;
+    CHECK_STATE();
+    return *this;
+  }
+
+  /* Move assignment: steals elements from another list */
+  PersistentList &operator=(PersistentList &&other) {
+    if (this == &other) {
+      return *this;
+    }
+    release(m_root);
+    m_root = other.m_root;
+    m_pos = other.m_pos;
+    other.m_root = nullptr;
+    other.m_pos = 0;
+    CHECK_STATE();
+    return *this;
+  }
+
+  /* Destructor: frees the nodes no other list refers to */
+  ~PersistentList() { release(m_root); }
+
+private:
+  /* helper methods */
+
+  std::uint32_t random_priority() {
+    // xorshift64
+    m_random ^= m_random << 13;
+    m_random ^= m_random >> 7;
+    m_random ^= m_random << 17;
+    return std::uint32_t(m_random >> 32);
+  }
+
+  static inline size_t size(const node *n) { return n ? n->size : 0; }
+
+  static inline void update_size(node *n) {
+    n->size = size(n->left) + 1 + size(n->right);
+  }
+
+  template <class... R> node *create_node(R &&...params) {
+    node *n = allocator_traits::allocate(m_allocator, 1);
+    try {
+      allocator_traits::construct(m_allocator, n, random_priority(),
+                                  std::forward<R>(params)...);
+    } catch (...) {
+      allocator_traits::deallocate(m_allocator, n, 1);
+      throw;
+    }
+    return n;
+  }
+
+  /* Adds a reference to n */
+  static inline node *acquire(node *n) {
+    if (n) {
+      n->refs++;
+    }
+    return n;
+  }
+
+  /* Drops a reference to n, freeing it and releasing its children once no
+   * references are left */
+  void release(node *n) {
+    if (n && --n->refs == 0) {
+      release(n->left);
+      release(n->right);
+      allocator_traits::destroy(m_allocator, n);
+      allocator_traits::deallocate(m_allocator, n, 1);
+    }
+  }
+
+  /* Takes a reference to n and returns a node with the same contents that
+   * only the caller refers to, so it can be modified. n itself is returned
+   * if the reference was the only one, otherwise it is copied. */
+  node *own(node *n) {
+    if (n->refs == 1) {
+      return n;
+    }
+    node *copy = create_node(n->value);
+    copy->priority = n->priority;
+    copy->left = acquire(n->left);
+    copy->right = acquire(n->right);
+    copy->size = n->size;
+    release(n);
+    return copy;
+  }
+
+  /* Takes a reference to t and splits it into the first k elements and the
+   * rest. Subtrees that fall entirely on one side are shared, not copied. */
+  std::pair<node *, node *> split(node *t, size_t k) {
+    if (k == 0) {
+      return {nullptr, t};
+    }
+    if (k == size(t)) {
+      return {t, nullptr};
+    }
+    t = own(t);
+    size_t left = size(t->left);
+    if (k <= left) {
+      auto [first, rest] = split(t->left, k);
+      t->left = rest;
+      update_size(t);
+      return {first, t};
+    } else {
+      auto [first, rest] = split(t->right, k - left - 1);
+      t->right = first;
+      update_size(t);
+      return {t, rest};
+    }
+  }
+
+  /* Takes references to a and b and joins them, the elements of a first */
+  node *merge(node *a, node *b) {
+    if (!a) {
+      return b;
+    }
+    if (!b) {
+      return a;
+    }
+    if (a->priority > b->priority) {
+      a = own(a);
+      a->right = merge(a->right, b);
+      update_size(a);
+      return a;
+    } else {
+      b = own(b);
+      b->left = merge(a, b->left);
+      update_size(b);
+      return b;
+    }
+  }
+
+  /* Inserts node n at position pos */
+  void insert_node(node *n, size_t pos) {
+    auto [first, rest] = split(m_root, pos);
+    m_root = merge(merge(first, n), rest);
+  }
+
+  /* Node at position pos, which must be less than the length */
+  const node *node_at(size_t pos) const {
+    const node *n = m_root;
+    while (true) {
+      size_t left = size(n->left);
+      if (pos < left) {
+        n = n->left;
+      } else if (pos == left) {
+        return n;
+      } else {
+        pos -= left + 1;
+        n = n->right;
+      }
+    }
+  }
+
+public:
+  /* Returns a list sharing the elements of this one, same as copying. */
+  PersistentList snapshot() const { return *this; }
+
+  /*  list interface implementation */
+
+  /* Clears list, leaving the elements to the lists that share them. */
+  void clear() override {
+    CHECK_STATE();
+    release(m_root);
+    m_root = nullptr;
+    m_pos = 0;
+  }
+
+  /* Constructs element at current position from params. */
+  template <class... R>
+  requires std::constructible_from<T, R...>
+  void emplace(R &&...params) {
+    CHECK_STATE();
+    insert_node(create_node(std::forward<R>(params)...), m_pos);
+  }
+
+  /* Constructs element at the end of the list from params. */
+  template <class... R>
+  requires std::constructible_from<T, R...>
+  void emplace_back(R &&...params) {
+    CHECK_STATE();
+    insert_node(create_node(std::forward<R>(params)...), size(m_root));
+  }
+
+  /* Inserts copy of element at current position. */
+  void insert(const T &item) override { emplace(item); }
+
+  /* Inserts element at current position by moving it. */
+  void insert(T &&item) override { emplace(std::move(item)); }
+
+  /* Appends copy of element at the end of the list. */
+  void append(const T &item) override { emplace_back(item); }
+
+  /* Appends element at the end of the list by moving it. */
+  void append(T &&item) override { emplace_back(std::move(item)); }
+
+  /* Remove element at current position and return it. The element is
+   * copied if another list still shares it. */
+  T remove() override {
+    CHECK_STATE();
+    if (!m_root) {
+      throw std::runtime_error("Attempt to remove from an empty list.");
+    }
+    auto [first, rest] = split(m_root, m_pos);
+    auto [removed, last] = split(rest, 1);
+    T item = removed->refs == 1 ? T(std::move(removed->value))
+                                : T(removed->value);
+    release(removed);
+    m_root = merge(first, last);
+    if (m_pos == size(m_root) && m_pos > 0) {
+      m_pos--;
+    }
+    return item;
+  }
+
+  /* Set the current position at the start of the list. */
+  void moveToStart() override {
+    CHECK_STATE();
+    m_pos = 0;
+  }
+
+  /* Set the current position at the end of the list. */
+  void moveToEnd() override {
+    CHECK_STATE();
+    if (m_root) {
+      m_pos = m_root->size - 1;
+    }
+  }
+
+  /* Move the current position one step left unless already at the
+   * beginning. */
+  void prev() override {
+    CHECK_STATE();
+    if (m_pos > 0) {
+      m_pos--;
+    }
+  }
+
+  /* Move the current position one step right unless already at the end. */
+  void next() override {
+    CHECK_STATE();
+    if (m_pos + 1 < size(m_root)) {
+      m_pos++;
+    }
+  }
+
+  /* Return the number of items in the list. */
+  size_t length() const override {
+    CHECK_STATE();
+    return size(m_root);
+  }
+
+  /* Return the current position of the list. */
+  size_t currPos() const override {
+    CHECK_STATE();
+    return m_pos;
+  }
+
+  /* Set current position. */
+  void moveToPos(size_t pos) override {
+    CHECK_STATE();
+    if (pos >= size(m_root)) {
+      throw std::runtime_error(
+          "Attempt to move to position beyond the length of the list.");
+    }
+    m_pos = pos;
+  }
+
+  /* Return the value of the current element, in O(log n) */
+  const T &getValue() const override {
+    CHECK_STATE();
+    if (!m_root) {
+      throw std::runtime_error("Attempting to access element from empty list.");
+    }
+    return node_at(m_pos)->value;
+  }
+
+  /* Search for an item in the list, returns npos ( (size_t) -1 ) if not found.
+   */
+  size_t Search(const T &item) const override {
+    size_t i = 0;
+    for (const T &value : *this) {
+      if (value == item) {
+        return i;
+      }
+      i++;
+    }
+    return npos;
+  }
+
+  /* In order iterator, keeps the path from the root to the current node */
+  class const_iterator {
+    std::vector<const node *> m_path;
+
+    void push_left(const node *n) {
+      for (; n; n = n->left) {
+        m_path.push_back(n);
+      }
+    }
+
+  public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = T;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const T *;
+    using reference = const T &;
+
+    const_iterator() = default;
+    explicit const_iterator(const node *root) { push_left(root); }
+
+    reference operator*() const { return m_path.back()->value; }
+    pointer operator->() const { return &m_path.back()->value; }
+
+    const_iterator &operator++() {
+      const node *n = m_path.back();
+      m_path.pop_back();
+      push_left(n->right);
+      return *this;
+    }
+
+    const_iterator operator++(int) {
+      const_iterator old = *this;
+      ++*this;
+      return old;
+    }
+
+    bool operator==(const const_iterator &other) const {
+      if (m_path.empty() || other.m_path.empty()) {
+        return m_path.empty() && other.m_path.empty();
+      }
+      return m_path.back() == other.m_path.back();
+    }
+  };
+
+  using iterator = const_iterator;
+
+  const_iterator begin() const { return const_iterator(m_root); }
+  const_iterator end() const { return const_iterator(); }
+  const_iterator cbegin() const { return begin(); }
+  const_iterator cend() const { return end(); }
+
+#undef CHECK_STATE
+};
+
+} // namespace cse204
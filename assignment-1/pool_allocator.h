@@ -0,0 +1,232 @@
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+namespace cse204 {
+
+/* Allocator that can free all of its memory at once. Containers can skip
+ * deallocating elements one by one when clearing. */
+template <class A>
+concept ReleasableAllocator = requires(A &allocator) { allocator.release(); };
+
+namespace detail {
+
+/* Pool of one type of slot, the pools of an allocator and the copies rebound
+ * from it are chained in one group */
+struct slab_pool_base {
+  slab_pool_base *next = nullptr;
+  /* identifies the type of the pool within the group */
+  const void *key;
+
+  explicit slab_pool_base(const void *key) : key(key) {}
+  virtual ~slab_pool_base() = default;
+};
+
+/* Pools shared by the copies of an allocator, freed with the last copy */
+struct slab_pool_group {
+  slab_pool_base *pools = nullptr;
+
+  slab_pool_group() = default;
+  slab_pool_group(const slab_pool_group &) = delete;
+  slab_pool_group &operator=(const slab_pool_group &) = delete;
+
+  ~slab_pool_group() {
+    while (pools) {
+      slab_pool_base *p = pools;
+      pools = p->next;
+      delete p;
+    }
+  }
+};
+
+} // namespace detail
+
+/* Allocator for node based containers. Single objects are carved out of
+ * slabs of SlabSize objects, so an allocation is either popping the free
+ * list of deallocated objects or bumping a pointer into the current slab.
+ * Arrays of more than one object are forwarded to std::allocator.
+ *
+ * Copies of an allocator share its pool and compare equal, so memory can be
+ * deallocated through any of them. Copies rebound to another type use a pool
+ * of their own type in the same group. A default constructed allocator
+ * starts a new group, and so does a copied container. Moving an allocator
+ * hands its group over. The pools are not thread-safe. */
+template <class T, std::size_t SlabSize = 256> class PoolAllocator {
+  static_assert(SlabSize > 0, "Slabs must hold at least one object");
+
+  template <class, std::size_t> friend class PoolAllocator;
+
+  /* Storage for one object, links to the next free slot when unused */
+  union slot {
+    slot *next;
+    alignas(T) unsigned char storage[sizeof(T)];
+  };
+
+  /* A block of slots, slabs are chained for releasing */
+  struct slab {
+    slab *next;
+    slot slots[SlabSize];
+  };
+
+  struct pool : detail::slab_pool_base {
+    /* Most recently allocated slab, objects are bumped out of it */
+    slab *slabs = nullptr;
+    /* Slots that have been deallocated */
+    slot *free = nullptr;
+    /* Index of the next unused slot in the most recent slab */
+    std::size_t bump = SlabSize;
+
+    pool() : slab_pool_base(&k_key) {}
+    ~pool() override { release(); }
+
+    void release() noexcept {
+      while (slabs) {
+        slab *s = slabs;
+        slabs = s->next;
+        delete s;
+      }
+      free = nullptr;
+      bump = SlabSize;
+    }
+  };
+
+  /* address identifies the pools of this type */
+  static inline const char k_key = 0;
+
+  std::shared_ptr<detail::slab_pool_group> m_group;
+  /* pool of this type in m_group, looked up on first use */
+  pool *m_pool = nullptr;
+
+  /* Returns the pool of this type in group. If there is none, adds it or
+   * returns nullptr depending on create. */
+  static pool *find_pool(detail::slab_pool_group &group, bool create = true) {
+    for (detail::slab_pool_base *p = group.pools; p; p = p->next) {
+      if (p->key == &k_key) {
+        return static_cast<pool *>(p);
+      }
+    }
+    if (!create) {
+      return nullptr;
+    }
+    pool *p = new pool;
+    p->next = group.pools;
+    group.pools = p;
+    return p;
+  }
+
+  /* Returns the pool of this type, a moved from allocator starts a new
+   * group */
+  pool &get_pool() {
+    if (!m_pool) {
+      if (!m_group) {
+        m_group = std::make_shared<detail::slab_pool_group>();
+      }
+      m_pool = find_pool(*m_group);
+    }
+    return *m_pool;
+  }
+
+public:
+  using value_type = T;
+  using size_type = std::size_t;
+  using difference_type = std::ptrdiff_t;
+  using propagate_on_container_move_assignment = std::true_type;
+  using propagate_on_container_swap = std::true_type;
+  using is_always_equal = std::false_type;
+
+  template <class U> struct rebind {
+    using other = PoolAllocator<U, SlabSize>;
+  };
+
+  PoolAllocator()
+      : m_group(std::make_shared<detail::slab_pool_group>()),
+        m_pool(find_pool(*m_group)) {}
+
+  /* Copies share the pool */
+  PoolAllocator(const PoolAllocator &) noexcept = default;
+  PoolAllocator &operator=(const PoolAllocator &) noexcept = default;
+
+  /* Moving hands the pool over, so releasing through the moved from
+   * allocator cannot free memory of the new owner */
+  PoolAllocator(PoolAllocator &&other) noexcept
+      : m_group(std::move(other.m_group)),
+        m_pool(std::exchange(other.m_pool, nullptr)) {}
+
+  PoolAllocator &operator=(PoolAllocator &&other) noexcept {
+    if (this == &other) {
+      return *this;
+    }
+    m_group = std::move(other.m_group);
+    m_pool = std::exchange(other.m_pool, nullptr);
+    return *this;
+  }
+
+  /* Shares the group of other, using the pool of T in it */
+  template <class U>
+  PoolAllocator(const PoolAllocator<U, SlabSize> &other) noexcept
+      : m_group(other.m_group) {}
+
+  /* A copied container gets a pool of its own, so releasing the pool of one
+   * container does not free the nodes of the other */
+  PoolAllocator select_on_container_copy_construction() const {
+    return PoolAllocator();
+  }
+
+  /* Allocates memory for n objects of T */
+  T *allocate(size_type n) {
+    if (n != 1) {
+      return std::allocator<T>().allocate(n);
+    }
+    pool &p = get_pool();
+    if (p.free) {
+      slot *s = p.free;
+      p.free = s->next;
+      return reinterpret_cast<T *>(s->storage);
+    }
+    if (p.bump == SlabSize) {
+      slab *s = new slab;
+      s->next = p.slabs;
+      p.slabs = s;
+      p.bump = 0;
+    }
+    return reinterpret_cast<T *>(p.slabs->slots[p.bump++].storage);
+  }
+
+  /* Returns memory of n objects of T to the pool */
+  void deallocate(T *p, size_type n) noexcept {
+    if (n != 1) {
+      std::allocator<T>().deallocate(p, n);
+      return;
+    }
+    // the pool exists, since an equal allocator allocated p from it
+    pool &owner = get_pool();
+    slot *s = reinterpret_cast<slot *>(p);
+    s->next = owner.free;
+    owner.free = s;
+  }
+
+  /* Frees every slab of the pool of T at once. All objects allocated from it,
+   * through any copy, must already be destroyed, and their memory must not
+   * be used anymore. */
+  void release() noexcept {
+    if (!m_pool && m_group) {
+      m_pool = find_pool(*m_group, false);
+    }
+    if (m_pool) {
+      m_pool->release();
+    }
+  }
+
+  /* Whether memory from one allocator can be deallocated through the other,
+   * which holds when they share the pools */
+  template <class U>
+  bool operator==(const PoolAllocator<U, SlabSize> &other) const noexcept {
+    return m_group == other.m_group;
+  }
+};
+
+} // namespace cse204
@@ -0,0 +1,164 @@
+#pragma once
+
+#include <algorithm>
+#include <concepts>
+#include <cstdint>
+#include <cstring>
+#include <istream>
+#include <iterator>
+#include <memory>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+
+#include "fast_io.h"
+#include "list.h"
+
+namespace cse204 {
+
+/* Types that lists can write to and read from binary streams. Trivially
+ * copyable values are stored as their bytes in memory, strings as their
+ * length followed by their characters. The data is only meant to be read
+ * back on a machine with the same byte order and type sizes. */
+template <class T>
+concept BinarySerializable =
+    std::is_trivially_copyable_v<T> || std::same_as<T, std::string>;
+
+namespace serialization {
+
+/* Elements are copied in blocks of this size when they are not contiguous */
+constexpr std::size_t k_block_size = 4096;
+
+inline void write_bytes(std::ostream &out, const void *data, std::size_t n) {
+  out.write(static_cast<const char *>(data), n);
+}
+
+inline void read_bytes(std::istream &in, void *data, std::size_t n) {
+  if (!in.read(static_cast<char *>(data), n)) {
+    throw std::runtime_error("Unexpected end of serialized list.");
+  }
+}
+
+/* Lists start with their length and current position */
+inline void write_header(std::ostream &out, std::size_t length,
+                         std::size_t pos) {
+  std::uint64_t header[2] = {length, pos};
+  write_bytes(out, header, sizeof(header));
+}
+
+struct header {
+  std::size_t length;
+  std::size_t pos;
+};
+
+inline header read_header(std::istream &in) {
+  std::uint64_t h[2];
+  read_bytes(in, h, sizeof(h));
+  if (h[0] == 0 ? h[1] != 0 : h[1] >= h[0]) {
+    throw std::runtime_error("Invalid position in serialized list.");
+  }
+  return {std::size_t(h[0]), std::size_t(h[1])};
+}
+
+template <BinarySerializable T>
+void write_value(std::ostream &out, const T &value) {
+  if constexpr (std::same_as<T, std::string>) {
+    std::uint64_t size = value.size();
+    write_bytes(out, &size, sizeof(size));
+    write_bytes(out, value.data(), value.size());
+  } else {
+    write_bytes(out, &value, sizeof(T));
+  }
+}
+
+template <BinarySerializable T> T read_value(std::istream &in) {
+  if constexpr (std::same_as<T, std::string>) {
+    std::uint64_t size;
+    read_bytes(in, &size, sizeof(size));
+    std::string value(size, '\0');
+    read_bytes(in, value.data(), size);
+    return value;
+  } else {
+    alignas(T) unsigned char bytes[sizeof(T)];
+    read_bytes(in, bytes, sizeof(T));
+    return *std::launder(reinterpret_cast<T *>(bytes));
+  }
+}
+
+/* Writes count elements starting at first. Contiguous trivially copyable
+ * elements are written with a single call, other trivially copyable ones
+ * are gathered into blocks first. */
+template <std::input_iterator I>
+requires BinarySerializable<std::iter_value_t<I>>
+void write_items(std::ostream &out, I first, std::size_t count) {
+  using T = std::iter_value_t<I>;
+  if constexpr (std::is_trivially_copyable_v<T> &&
+                std::contiguous_iterator<I>) {
+    write_bytes(out, std::to_address(first), count * sizeof(T));
+  } else if constexpr (std::is_trivially_copyable_v<T>) {
+    constexpr std::size_t per_block =
+        std::max(k_block_size / sizeof(T), std::size_t(1));
+    alignas(T) unsigned char block[per_block * sizeof(T)];
+    while (count > 0) {
+      std::size_t n = std::min(count, per_block);
+      for (std::size_t i = 0; i < n; i++, ++first) {
+        std::memcpy(block + i * sizeof(T), std::addressof(*first), sizeof(T));
+      }
+      write_bytes(out, block, n * sizeof(T));
+      count -= n;
+    }
+  } else {
+    for (; count > 0; count--, ++first) {
+      write_value(out, *first);
+    }
+  }
+}
+
+/* Reads count elements and passes each of them to f. Trivially copyable
+ * elements are read in blocks. */
+template <BinarySerializable T, class F>
+void read_items(std::istream &in, std::size_t count, F &&f) {
+  if constexpr (std::is_trivially_copyable_v<T>) {
+    constexpr std::size_t per_block =
+        std::max(k_block_size / sizeof(T), std::size_t(1));
+    alignas(T) unsigned char block[per_block * sizeof(T)];
+    while (count > 0) {
+      std::size_t n = std::min(count, per_block);
+      read_bytes(in, block, n * sizeof(T));
+      for (std::size_t i = 0; i < n; i++) {
+        T *item = std::launder(reinterpret_cast<T *>(block + i * sizeof(T)));
+        f(std::move(*item));
+      }
+      count -= n;
+    }
+  } else {
+    for (; count > 0; count--) {
+      f(read_value<T>(in));
+    }
+  }
+}
+
+} // namespace serialization
+
+/* Print an iterable list to output stream in the same format as
+ * operator<<, buffering the output and formatting integers directly */
+template <IterableList L> void write_text(std::ostream &os, const L &list) {
+  FastWriter out(os);
+  out << '<';
+  const std::size_t curr_pos = list.currPos();
+  std::size_t i = 0;
+  for (const auto &item : list) {
+    if (i > 0) {
+      out << ' ';
+    }
+    if (i == curr_pos) {
+      out << "| ";
+    }
+    out << item;
+    i++;
+  }
+  out << '>';
+}
+
+} // namespace cse204
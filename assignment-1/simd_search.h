@@ -0,0 +1,228 @@
+#pragma once
+
+#include <bit>
+#include <concepts>
+#include <cstddef>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace cse204::simd {
+
+using std::size_t;
+
+/* Types whose equality can be checked a vector of elements at a time. Equal
+ * floating point values compare equal lane-wise exactly as with ==. */
+template <class T>
+concept Searchable =
+    (std::integral<T> || std::same_as<T, float> || std::same_as<T, double>) &&
+    !std::same_as<T, bool> &&
+    (sizeof(T) == 1 || sizeof(T) == 2 || sizeof(T) == 4 || sizeof(T) == 8);
+
+namespace detail {
+
+#if defined(__AVX2__) || defined(__SSE2__)
+#define CSE204_SIMD_SEARCH 1
+
+#if defined(__AVX2__)
+using vector_t = __m256i;
+inline vector_t load(const void *p) {
+  return _mm256_loadu_si256(static_cast<const __m256i *>(p));
+}
+inline unsigned byte_mask(vector_t v) {
+  return static_cast<unsigned>(_mm256_movemask_epi8(v));
+}
+#else
+using vector_t = __m128i;
+inline vector_t load(const void *p) {
+  return _mm_loadu_si128(static_cast<const __m128i *>(p));
+}
+inline unsigned byte_mask(vector_t v) {
+  return static_cast<unsigned>(_mm_movemask_epi8(v));
+}
+#endif
+
+constexpr size_t k_vector_bytes = sizeof(vector_t);
+
+/* Vector with every element set to value */
+template <Searchable T> vector_t broadcast(T value) {
+#if defined(__AVX2__)
+  if constexpr (std::same_as<T, float>) {
+    return _mm256_castps_si256(_mm256_set1_ps(value));
+  } else if constexpr (std::same_as<T, double>) {
+    return _mm256_castpd_si256(_mm256_set1_pd(value));
+  } else if constexpr (sizeof(T) == 1) {
+    return _mm256_set1_epi8(static_cast<char>(value));
+  } else if constexpr (sizeof(T) == 2) {
+    return _mm256_set1_epi16(static_cast<short>(value));
+  } else if constexpr (sizeof(T) == 4) {
+    return _mm256_set1_epi32(static_cast<int>(value));
+  } else {
+    return _mm256_set1_epi64x(static_cast<long long>(value));
+  }
+#else
+  if constexpr (std::same_as<T, float>) {
+    return _mm_castps_si128(_mm_set1_ps(value));
+  } else if constexpr (std::same_as<T, double>) {
+    return _mm_castpd_si128(_mm_set1_pd(value));
+  } else if constexpr (sizeof(T) == 1) {
+    return _mm_set1_epi8(static_cast<char>(value));
+  } else if constexpr (sizeof(T) == 2) {
+    return _mm_set1_epi16(static_cast<short>(value));
+  } else if constexpr (sizeof(T) == 4) {
+    return _mm_set1_epi32(static_cast<int>(value));
+  } else {
+    return _mm_set1_epi64x(static_cast<long long>(value));
+  }
+#endif
+}
+
+/* Every byte of an element is set in the result if the elements are equal */
+template <Searchable T> vector_t equal(vector_t a, vector_t b) {
+#if defined(__AVX2__)
+  if constexpr (std::same_as<T, float>) {
+    return _mm256_castps_si256(_mm256_cmp_ps(
+        _mm256_castsi256_ps(a), _mm256_castsi256_ps(b), _CMP_EQ_OQ));
+  } else if constexpr (std::same_as<T, double>) {
+    return _mm256_castpd_si256(_mm256_cmp_pd(
+        _mm256_castsi256_pd(a), _mm256_castsi256_pd(b), _CMP_EQ_OQ));
+  } else if constexpr (sizeof(T) == 1) {
+    return _mm256_cmpeq_epi8(a, b);
+  } else if constexpr (sizeof(T) == 2) {
+    return _mm256_cmpeq_epi16(a, b);
+  } else if constexpr (sizeof(T) == 4) {
+    return _mm256_cmpeq_epi32(a, b);
+  } else {
+    return _mm256_cmpeq_epi64(a, b);
+  }
+#else
+  if constexpr (std::same_as<T, float>) {
+    return _mm_castps_si128(
+        _mm_cmpeq_ps(_mm_castsi128_ps(a), _mm_castsi128_ps(b)));
+  } else if constexpr (std::same_as<T, double>) {
+    return _mm_castpd_si128(
+        _mm_cmpeq_pd(_mm_castsi128_pd(a), _mm_castsi128_pd(b)));
+  } else if constexpr (sizeof(T) == 1) {
+    return _mm_cmpeq_epi8(a, b);
+  } else if constexpr (sizeof(T) == 2) {
+    return _mm_cmpeq_epi16(a, b);
+  } else if constexpr (sizeof(T) == 4) {
+    return _mm_cmpeq_epi32(a, b);
+  } else {
+    // SSE2 has no 64 bit compare, both 32 bit halves have to be equal
+    vector_t halves = _mm_cmpeq_epi32(a, b);
+    return _mm_and_si128(halves,
+                         _mm_shuffle_epi32(halves, _MM_SHUFFLE(2, 3, 0, 1)));
+  }
+#endif
+}
+
+/* Calls f(i) for the index i of each element of data[0..n) equal to value,
+ * stops early if f returns false */
+template <Searchable T, class F>
+void scan(const T *data, size_t n, T value, F &&f) {
+  constexpr size_t width = k_vector_bytes / sizeof(T);
+  const vector_t needle = broadcast(value);
+
+  size_t i = 0;
+  for (; i + width <= n; i += width) {
+    unsigned mask = byte_mask(equal<T>(load(data + i), needle));
+    while (mask) {
+      // each matching element sets sizeof(T) consecutive bits
+      unsigned bit = std::countr_zero(mask);
+      if (!f(i + bit / sizeof(T))) {
+        return;
+      }
+      mask &= ~(((1u << sizeof(T)) - 1) << bit);
+    }
+  }
+  for (; i < n; i++) {
+    if (data[i] == value && !f(i)) {
+      return;
+    }
+  }
+}
+
+/* Returns the number of elements of data[0..n) equal to value */
+template <Searchable T> size_t count(const T *data, size_t n, T value) {
+  constexpr size_t width = k_vector_bytes / sizeof(T);
+  const vector_t needle = broadcast(value);
+
+  size_t bits = 0;
+  size_t i = 0;
+  for (; i + width <= n; i += width) {
+    bits += std::popcount(byte_mask(equal<T>(load(data + i), needle)));
+  }
+  // each matching element sets sizeof(T) bits
+  size_t ret = bits / sizeof(T);
+  for (; i < n; i++) {
+    ret += data[i] == value;
+  }
+  return ret;
+}
+
+#endif
+
+/* Scalar version of scan, for types and targets without a vector path */
+template <class T, class F>
+void scan_scalar(const T *data, size_t n, const T &value, F &&f) {
+  for (size_t i = 0; i < n; i++) {
+    if (data[i] == value && !f(i)) {
+      return;
+    }
+  }
+}
+
+template <class T, class F>
+void dispatch_scan(const T *data, size_t n, const T &value, F &&f) {
+#ifdef CSE204_SIMD_SEARCH
+  if constexpr (Searchable<T>) {
+    scan(data, n, value, f);
+    return;
+  }
+#endif
+  scan_scalar(data, n, value, f);
+}
+
+} // namespace detail
+
+/* Returns index of the first element of data[0..n) equal to value, n if there
+ * is none */
+template <class T> size_t find(const T *data, size_t n, const T &value) {
+  size_t ret = n;
+  detail::dispatch_scan(data, n, value, [&](size_t i) {
+    ret = i;
+    return false;
+  });
+  return ret;
+}
+
+/* Returns the number of elements of data[0..n) equal to value */
+template <class T> size_t count(const T *data, size_t n, const T &value) {
+#ifdef CSE204_SIMD_SEARCH
+  if constexpr (Searchable<T>) {
+    return detail::count(data, n, value);
+  }
+#endif
+  size_t ret = 0;
+  detail::dispatch_scan(data, n, value, [&](size_t) {
+    ret++;
+    return true;
+  });
+  return ret;
+}
+
+/* Calls f(i) with the index i of every element of data[0..n) equal to value,
+ * in increasing order */
+template <class T, class F>
+void for_each_match(const T *data, size_t n, const T &value, F &&f) {
+  detail::dispatch_scan(data, n, value, [&](size_t i) {
+    f(i);
+    return true;
+  });
+}
+
+} // namespace cse204::simd
@@ -1,10 +1,34 @@
 #include "arraylist.h"
+#include "concurrentlist.h"
+#include "gapbufferlist.h"
+#include "indexedskiplist.h"
 #include "linkedlist.h"
+#include "persistentlist.h"
+#include "unrolledlinkedlist.h"
 #include <catch2/catch.hpp>
+#include <iterator>
+#include <limits>
+#include <map>
+#include <new>
+#include <sstream>
 #include <stdexcept>
-
-TEMPLATE_PRODUCT_TEST_CASE("List constructors", "[ArrayList][LinkedList]",
-                           (cse204::ArrayList, cse204::LinkedList), int) {
+#include <thread>
+#include <vector>
+
+/* Catch2 only takes templates with type parameters, so the node and inline
+ * capacities have to be bound */
+template <class T> using ArrayList = cse204::ArrayList<T>;
+template <class T> using SmallArrayList = cse204::SmallArrayList<T, 4>;
+template <class T> using UnrolledLinkedList = cse204::UnrolledLinkedList<T>;
+
+TEMPLATE_PRODUCT_TEST_CASE(
+    "List constructors",
+    "[ArrayList][LinkedList][PooledLinkedList][GapBufferList]"
+    "[UnrolledLinkedList][IndexedSkipList][SmallArrayList][PersistentList]",
+    (ArrayList, cse204::LinkedList, cse204::PooledLinkedList,
+     cse204::GapBufferList, UnrolledLinkedList, cse204::IndexedSkipList,
+     SmallArrayList, cse204::PersistentList),
+    int) {
   SECTION("Emtpy List Constructor") {
     TestType empty_list;
 
@@ -131,8 +155,14 @@ TEMPLATE_PRODUCT_TEST_CASE("List constructors", "[ArrayList][LinkedList]",
   }
 }
 
-TEMPLATE_PRODUCT_TEST_CASE("Assignment Operators", "[ArrayList][LinkedList]",
-                           (cse204::ArrayList, cse204::LinkedList), (int)) {
+TEMPLATE_PRODUCT_TEST_CASE(
+    "Assignment Operators",
+    "[ArrayList][LinkedList][PooledLinkedList][GapBufferList]"
+    "[UnrolledLinkedList][IndexedSkipList][SmallArrayList][PersistentList]",
+    (ArrayList, cse204::LinkedList, cse204::PooledLinkedList,
+     cse204::GapBufferList, UnrolledLinkedList, cse204::IndexedSkipList,
+     SmallArrayList, cse204::PersistentList),
+    (int)) {
   TestType other({0, 1, 2, 3, 4});
   other.moveToPos(2);
   TestType list;
@@ -181,8 +211,14 @@ TEMPLATE_PRODUCT_TEST_CASE("Assignment Operators", "[ArrayList][LinkedList]",
   }
 }
 
-TEMPLATE_PRODUCT_TEST_CASE("List Interface Methods", "[ArrayList][LinkedList]",
-                           (cse204::ArrayList, cse204::LinkedList), (int)) {
+TEMPLATE_PRODUCT_TEST_CASE(
+    "List Interface Methods",
+    "[ArrayList][LinkedList][PooledLinkedList][GapBufferList]"
+    "[UnrolledLinkedList][IndexedSkipList][SmallArrayList][PersistentList]",
+    (ArrayList, cse204::LinkedList, cse204::PooledLinkedList,
+     cse204::GapBufferList, UnrolledLinkedList, cse204::IndexedSkipList,
+     SmallArrayList, cse204::PersistentList),
+    (int)) {
   TestType list = {0, 1, 2, 3, 4};
 
   SECTION("1. clear: should empty list, but keep it valid") {
@@ -392,8 +428,14 @@ TEMPLATE_PRODUCT_TEST_CASE("List Interface Methods", "[ArrayList][LinkedList]",
   }
 }
 
-TEMPLATE_PRODUCT_TEST_CASE("List of 100 elements", "[ArrayList][LinkedList]",
-                           (cse204::ArrayList, cse204::LinkedList), (int)) {
+TEMPLATE_PRODUCT_TEST_CASE(
+    "List of 100 elements",
+    "[ArrayList][LinkedList][PooledLinkedList][GapBufferList]"
+    "[UnrolledLinkedList][IndexedSkipList][SmallArrayList][PersistentList]",
+    (ArrayList, cse204::LinkedList, cse204::PooledLinkedList,
+     cse204::GapBufferList, UnrolledLinkedList, cse204::IndexedSkipList,
+     SmallArrayList, cse204::PersistentList),
+    (int)) {
   TestType list;
   for (int i = 99; i >= 0; i--) {
     list.insert(i);
@@ -507,6 +549,22 @@ TEMPLATE_PRODUCT_TEST_CASE("List of 100 elements", "[ArrayList][LinkedList]",
     }
   }
 
+  SECTION("Seeking in any direction should land on the right element") {
+    for (int i = 0; i < 100; i++) {
+      int pos = (i * 37) % 100;
+      list.moveToPos(pos);
+      REQUIRE(list.currPos() == pos);
+      REQUIRE(list.getValue() == pos);
+    }
+    list.moveToPos(98);
+    list.remove();
+    list.moveToEnd();
+    list.prev();
+    REQUIRE(list.getValue() == 97);
+    list.moveToPos(1);
+    REQUIRE(list.getValue() == 1);
+  }
+
   SECTION("Search should yield correct results") {
     REQUIRE(list.Search(49) == 49);
     REQUIRE(list.Search(99) == 99);
@@ -519,3 +577,1184 @@ TEMPLATE_PRODUCT_TEST_CASE("List of 100 elements", "[ArrayList][LinkedList]",
     REQUIRE(list.currPos() == 0);
   }
 }
+
+TEST_CASE("ArrayList capacity management", "[ArrayList]") {
+  SECTION("Geometric growth should multiply capacity") {
+    cse204::ArrayList<int> list(4, 2.0);
+    for (int i = 0; i < 5; i++) {
+      list.append(i);
+    }
+    CHECK(list.capacity() == 8);
+    for (int i = 5; i < 9; i++) {
+      list.append(i);
+    }
+    CHECK(list.capacity() == 16);
+    CHECK(cse204::to_string(list) == "<| 0 1 2 3 4 5 6 7 8>");
+  }
+
+  SECTION("Chunked growth should add chunk size to capacity") {
+    cse204::ArrayList<int> list(4, 1.0);
+    for (int i = 0; i < 9; i++) {
+      list.append(i);
+    }
+    CHECK(list.capacity() == 12);
+    CHECK(cse204::to_string(list) == "<| 0 1 2 3 4 5 6 7 8>");
+  }
+
+  SECTION("Reserve should only ever increase capacity") {
+    cse204::ArrayList<int> list = {0, 1, 2};
+    list.moveToPos(1);
+    list.reserve(100);
+    CHECK(list.capacity() == 100);
+    list.reserve(10);
+    CHECK(list.capacity() == 100);
+    CHECK(cse204::to_string(list) == "<0 | 1 2>");
+
+    for (int i = 3; i < 100; i++) {
+      list.append(i);
+    }
+    CHECK(list.capacity() == 100);
+  }
+
+  SECTION("Shrink to fit should reduce capacity to length") {
+    cse204::ArrayList<int> list = {0, 1, 2};
+    list.reserve(100);
+    list.shrink_to_fit();
+    CHECK(list.capacity() == 3);
+    CHECK(cse204::to_string(list) == "<| 0 1 2>");
+
+    list.clear();
+    list.shrink_to_fit();
+    CHECK(list.capacity() == 0);
+    list.append(0);
+    CHECK(cse204::to_string(list) == "<| 0>");
+  }
+}
+
+/* Counts copies made of it, to check that lists move elements */
+struct CopyCounter {
+  inline static int copies = 0;
+  int value = 0;
+
+  CopyCounter() = default;
+  CopyCounter(int value) : value(value) {}
+  CopyCounter(const CopyCounter &other) : value(other.value) { copies++; }
+  CopyCounter(CopyCounter &&other) = default;
+  CopyCounter &operator=(const CopyCounter &other) {
+    value = other.value;
+    copies++;
+    return *this;
+  }
+  CopyCounter &operator=(CopyCounter &&other) = default;
+  bool operator==(const CopyCounter &other) const = default;
+};
+
+TEMPLATE_PRODUCT_TEST_CASE(
+    "Move aware operations",
+    "[ArrayList][LinkedList][PooledLinkedList][GapBufferList]"
+    "[UnrolledLinkedList][IndexedSkipList][SmallArrayList][PersistentList]",
+    (ArrayList, cse204::LinkedList, cse204::PooledLinkedList,
+     cse204::GapBufferList, UnrolledLinkedList, cse204::IndexedSkipList,
+     SmallArrayList, cse204::PersistentList),
+    (CopyCounter)) {
+  TestType list;
+  CopyCounter::copies = 0;
+
+  SECTION("Emplace should construct elements without copying") {
+    for (int i = 0; i < 100; i++) {
+      list.emplace_back(i);
+    }
+    list.moveToPos(50);
+    list.emplace(-1);
+    list.insert(CopyCounter(-2));
+    list.append(CopyCounter(100));
+
+    CHECK(list.length() == 103);
+    CHECK(list.getValue().value == -2);
+    CHECK(list.remove().value == -2);
+    CHECK(list.remove().value == -1);
+    CHECK(list.getValue().value == 50);
+    list.moveToEnd();
+    CHECK(list.getValue().value == 100);
+    CHECK(CopyCounter::copies == 0);
+  }
+
+  SECTION("Copying insert and append should copy exactly once") {
+    CopyCounter item(7);
+    list.append(item);
+    list.insert(item);
+    CHECK(CopyCounter::copies == 2);
+    CHECK(list.length() == 2);
+  }
+}
+
+/* Tracks number of live instances, and cannot be default constructed */
+struct LiveCounter {
+  inline static int live = 0;
+  int value;
+
+  LiveCounter(int value) : value(value) { live++; }
+  LiveCounter(const LiveCounter &other) : value(other.value) { live++; }
+  LiveCounter &operator=(const LiveCounter &other) = default;
+  ~LiveCounter() { live--; }
+  bool operator==(const LiveCounter &other) const = default;
+};
+
+TEST_CASE("ArrayList uninitialised storage", "[ArrayList]") {
+  LiveCounter::live = 0;
+
+  SECTION("Capacity should not construct elements") {
+    cse204::ArrayList<LiveCounter> list;
+    list.reserve(1000);
+    CHECK(LiveCounter::live == 0);
+
+    for (int i = 0; i < 10; i++) {
+      list.emplace_back(i);
+    }
+    CHECK(LiveCounter::live == 10);
+    list.moveToPos(5);
+    list.emplace(-1);
+    CHECK(LiveCounter::live == 11);
+    CHECK(list.remove().value == -1);
+    CHECK(LiveCounter::live == 10);
+  }
+
+  SECTION("Every element should be destroyed exactly once") {
+    {
+      cse204::ArrayList<LiveCounter> list;
+      for (int i = 0; i < 100; i++) {
+        list.append(LiveCounter(i));
+      }
+      cse204::ArrayList<LiveCounter> copy = list;
+      list.clear();
+      CHECK(LiveCounter::live == 100);
+      list = copy;
+      list.shrink_to_fit();
+      CHECK(LiveCounter::live == 200);
+      copy = std::move(list);
+      CHECK(LiveCounter::live == 100);
+    }
+    CHECK(LiveCounter::live == 0);
+  }
+}
+
+TEST_CASE("Small array list inline storage", "[SmallArrayList]") {
+  using List = cse204::SmallArrayList<std::string, 4>;
+  LiveCounter::live = 0;
+
+  SECTION("Elements should stay inline until the inline capacity is full") {
+    List list;
+    CHECK(list.capacity() == 4);
+    for (int i = 0; i < 4; i++) {
+      list.append(std::to_string(i));
+    }
+    CHECK(list.capacity() == 4);
+    list.append("4");
+    CHECK(list.capacity() > 4);
+    CHECK(cse204::to_string(list) == "<| 0 1 2 3 4>");
+
+    list.moveToEnd();
+    list.remove();
+    list.shrink_to_fit();
+    CHECK(list.capacity() == 4);
+    CHECK(cse204::to_string(list) == "<0 1 2 | 3>");
+  }
+
+  SECTION("Moving should keep inline and allocated elements") {
+    List small = {"a", "b"};
+    List large = {"c", "d", "e", "f", "g", "h"};
+    small.moveToEnd();
+
+    List moved_small(std::move(small));
+    CHECK(cse204::to_string(moved_small) == "<a | b>");
+    CHECK(small.length() == 0);
+    CHECK(small.capacity() == 4);
+    small.append("i");
+    CHECK(cse204::to_string(small) == "<| i>");
+
+    List moved_large(std::move(large));
+    CHECK(cse204::to_string(moved_large) == "<| c d e f g h>");
+    CHECK(large.length() == 0);
+
+    // inline into allocated, allocated into inline and inline into inline
+    moved_large = std::move(moved_small);
+    CHECK(cse204::to_string(moved_large) == "<a | b>");
+    large = {"j", "k", "l", "m", "n"};
+    small = std::move(large);
+    CHECK(cse204::to_string(small) == "<| j k l m n>");
+    large = std::move(moved_large);
+    CHECK(cse204::to_string(large) == "<a | b>");
+    CHECK(moved_large.length() == 0);
+    moved_large.append("o");
+    CHECK(cse204::to_string(moved_large) == "<| o>");
+  }
+
+  SECTION("Every element should be destroyed exactly once") {
+    {
+      cse204::SmallArrayList<LiveCounter, 4> a, b;
+      for (int i = 0; i < 3; i++) {
+        a.append(LiveCounter(i));
+      }
+      b = a;
+      CHECK(LiveCounter::live == 6);
+      for (int i = 3; i < 10; i++) {
+        b.append(LiveCounter(i));
+      }
+      a = std::move(b);
+      CHECK(LiveCounter::live == 10);
+      b = std::move(a);
+      CHECK(LiveCounter::live == 10);
+      cse204::SmallArrayList<LiveCounter, 4> c(std::move(b));
+      CHECK(LiveCounter::live == 10);
+      c.shrink_to_fit();
+    }
+    CHECK(LiveCounter::live == 0);
+  }
+}
+
+TEST_CASE("Concurrent list", "[ConcurrentList]") {
+  SECTION("Appends should be visible in order from a single thread") {
+    cse204::ConcurrentList<std::string> list;
+    CHECK(list.length() == 0);
+    CHECK(list.Search("0") == (size_t)-1);
+    for (int i = 0; i < 1000; i++) {
+      list.append(std::to_string(i));
+    }
+    CHECK(list.length() == 1000);
+    CHECK(list.at(0) == "0");
+    CHECK(list.at(999) == "999");
+    CHECK_THROWS_AS(list.at(1000), std::runtime_error);
+    CHECK(list.Search("500") == 500);
+    CHECK(std::distance(list.begin(), list.end()) == 1000);
+
+    const std::string &first = list.at(0);
+    for (int i = 1000; i < 5000; i++) {
+      list.emplace_back(std::to_string(i));
+    }
+    // segments are never moved
+    CHECK(&first == &list.at(0));
+
+    list.clear();
+    CHECK(list.length() == 0);
+    list.append("0");
+    CHECK(list.Search("0") == 0);
+  }
+
+  SECTION("Concurrent appends should all be published exactly once") {
+    constexpr int threads = 4, per_thread = 20000;
+    cse204::ConcurrentList<int> list;
+    std::vector<std::thread> writers;
+    for (int t = 0; t < threads; t++) {
+      writers.emplace_back([&list, t]() {
+        for (int i = 0; i < per_thread; i++) {
+          list.append(t * per_thread + i);
+        }
+      });
+    }
+    // every element a reader can see is constructed
+    bool consistent = true;
+    size_t seen = 0;
+    while (seen < threads * per_thread) {
+      size_t length = list.length();
+      consistent = consistent && length >= seen;
+      for (; seen < length; seen++) {
+        int value = list.at(seen);
+        consistent = consistent && value >= 0 && value < threads * per_thread;
+      }
+    }
+    for (auto &writer : writers) {
+      writer.join();
+    }
+    CHECK(consistent);
+    REQUIRE(list.length() == threads * per_thread);
+
+    std::vector<int> count(threads * per_thread, 0);
+    for (int value : list) {
+      count[value]++;
+    }
+    CHECK(std::all_of(count.begin(), count.end(),
+                      [](int c) { return c == 1; }));
+  }
+}
+
+TEST_CASE("Persistent list snapshots", "[PersistentList]") {
+  LiveCounter::live = 0;
+
+  SECTION("Modifying a list should leave its snapshots unchanged") {
+    cse204::PersistentList<int> list;
+    for (int i = 0; i < 100; i++) {
+      list.append(i);
+    }
+    list.moveToPos(50);
+    auto snapshot = list.snapshot();
+
+    list.insert(-1);
+    list.moveToStart();
+    CHECK(list.remove() == 0);
+    list.moveToEnd();
+    list.append(100);
+    CHECK(list.length() == 101);
+
+    CHECK(snapshot.length() == 100);
+    CHECK(snapshot.currPos() == 50);
+    CHECK(snapshot.getValue() == 50);
+    CHECK(snapshot.Search(-1) == (size_t)-1);
+    CHECK(list.Search(-1) == 49);
+    CHECK(list.Search(100) == 100);
+
+    // restoring a snapshot undoes the changes
+    list = snapshot;
+    CHECK(list.length() == 100);
+    CHECK(list.getValue() == 50);
+    CHECK(std::equal(list.begin(), list.end(), snapshot.begin()));
+  }
+
+  SECTION("Chains of snapshots should each keep their own elements") {
+    std::vector<cse204::PersistentList<int>> versions(1);
+    for (int i = 0; i < 50; i++) {
+      cse204::PersistentList<int> next = versions.back();
+      if (next.length() > 0) {
+        next.moveToPos(next.length() / 2);
+      }
+      next.insert(i);
+      versions.push_back(std::move(next));
+    }
+    for (size_t v = 0; v < versions.size(); v++) {
+      REQUIRE(versions[v].length() == v);
+    }
+    std::vector<int> sorted(versions.back().begin(), versions.back().end());
+    std::sort(sorted.begin(), sorted.end());
+    for (int i = 0; i < 50; i++) {
+      CHECK(sorted[i] == i);
+    }
+  }
+
+  SECTION("Every element should be destroyed exactly once") {
+    {
+      cse204::PersistentList<LiveCounter> list;
+      for (int i = 0; i < 100; i++) {
+        list.append(LiveCounter(i));
+      }
+      cse204::PersistentList<LiveCounter> snapshot = list;
+      CHECK(LiveCounter::live == 100);
+
+      list.moveToPos(10);
+      list.remove();
+      list.insert(LiveCounter(-1));
+      // the removed element is still part of the snapshot
+      CHECK(LiveCounter::live >= 101);
+      snapshot.clear();
+      CHECK(LiveCounter::live == 100);
+
+      snapshot = list;
+      list.clear();
+      CHECK(LiveCounter::live == 100);
+    }
+    CHECK(LiveCounter::live == 0);
+  }
+}
+
+TEST_CASE("Pool allocator", "[PoolAllocator]") {
+  cse204::PoolAllocator<void *, 4> pool;
+
+  SECTION("Allocations should be bumped out of one slab") {
+    void **a = pool.allocate(1);
+    void **b = pool.allocate(1);
+    void **c = pool.allocate(1);
+    CHECK(b == a + 1);
+    CHECK(c == b + 1);
+  }
+
+  SECTION("Deallocated memory should be reused first") {
+    void **a = pool.allocate(1);
+    pool.allocate(1);
+    pool.deallocate(a, 1);
+    CHECK(pool.allocate(1) == a);
+  }
+
+  SECTION("Arrays should be allocated outside of the pool") {
+    void **a = pool.allocate(8);
+    a[7] = nullptr;
+    pool.deallocate(a, 8);
+  }
+
+  SECTION("Moved into allocator should own the slabs") {
+    void **a = pool.allocate(1);
+    cse204::PoolAllocator<void *, 4> other = std::move(pool);
+    other.deallocate(a, 1);
+    CHECK(other.allocate(1) == a);
+    // the moved from allocator starts over and can release on its own
+    pool.allocate(1);
+    pool.release();
+    CHECK(other.allocate(1) == a + 1);
+  }
+
+  SECTION("Copies should share the pool") {
+    cse204::PoolAllocator<void *, 4> copy = pool;
+    CHECK(copy == pool);
+    CHECK_FALSE(cse204::PoolAllocator<void *, 4>() == pool);
+    void **a = pool.allocate(1);
+    copy.deallocate(a, 1);
+    CHECK(copy.allocate(1) == a);
+    CHECK(pool.allocate(1) == a + 1);
+  }
+
+  SECTION("Rebound copies should compare equal to the original") {
+    cse204::PoolAllocator<char, 4> rebound(pool);
+    CHECK(rebound == pool);
+    CHECK(cse204::PoolAllocator<void *, 4>(rebound) == pool);
+    void **a = pool.allocate(1);
+    cse204::PoolAllocator<void *, 4>(rebound).deallocate(a, 1);
+    CHECK(pool.allocate(1) == a);
+  }
+}
+
+TEST_CASE("Pooled linked list clear", "[PooledLinkedList]") {
+  cse204::PooledLinkedList<std::string> list;
+  for (int i = 0; i < 1000; i++) {
+    list.append(std::to_string(i));
+  }
+  list.clear();
+  CHECK(list.length() == 0);
+  CHECK(cse204::to_string(list) == "<>");
+
+  list.append("a");
+  list.insert("b");
+  CHECK(cse204::to_string(list) == "<| b a>");
+}
+
+TEST_CASE("Pooled linked list copies and moves", "[PooledLinkedList]") {
+  cse204::PooledLinkedList<std::string> list = {"a", "b", "c"};
+
+  SECTION("Clearing a copy should not affect the original") {
+    cse204::PooledLinkedList<std::string> copy = list;
+    copy.clear();
+    copy.append("d");
+    CHECK(cse204::to_string(list) == "<| a b c>");
+  }
+
+  SECTION("Clearing a moved from list should not affect the new one") {
+    cse204::PooledLinkedList<std::string> moved = std::move(list);
+    list.append("d");
+    list.clear();
+    list.append("e");
+    CHECK(cse204::to_string(moved) == "<| a b c>");
+    CHECK(cse204::to_string(list) == "<| e>");
+  }
+}
+
+TEST_CASE("Gap buffer list edits", "[GapBufferList]") {
+  cse204::GapBufferList<std::string> list;
+  for (int i = 0; i < 10; i++) {
+    list.append(std::to_string(i));
+  }
+
+  SECTION("Edits far apart should keep order") {
+    list.moveToPos(2);
+    list.insert("a");
+    list.moveToPos(8);
+    list.insert("b");
+    list.moveToStart();
+    CHECK(list.remove() == "0");
+    list.moveToEnd();
+    list.insert("c");
+    CHECK(cse204::to_string(list) == "<1 a 2 3 4 5 6 b 7 8 | c 9>");
+    CHECK(list.Search("9") == 11);
+    CHECK(list.Search("a") == 1);
+    CHECK(list.Search("x") == -1);
+  }
+
+  SECTION("Inserting an element of the list should copy it first") {
+    list.moveToPos(9);
+    for (int i = 0; i < 20; i++) {
+      list.insert(list.getValue());
+    }
+    CHECK(list.length() == 30);
+    CHECK(std::count(list.begin(), list.end(), "9") == 21);
+
+    list.moveToStart();
+    list.append(list.getValue());
+    CHECK(list.Search("0") == 0);
+    list.moveToEnd();
+    CHECK(list.getValue() == "0");
+  }
+
+  SECTION("Edits on a full buffer should keep the elements") {
+    cse204::GapBufferList<std::string> full;
+    for (int i = 0; i < 8; i++) {
+      full.append("item" + std::to_string(i));
+    }
+    REQUIRE(full.length() == full.capacity());
+    full.moveToStart();
+    full.insert("x");
+    CHECK(full.getValue() == "x");
+    CHECK(full.Search("item7") == 8);
+
+    cse204::GapBufferList<std::string> removed;
+    for (int i = 0; i < 8; i++) {
+      removed.append("item" + std::to_string(i));
+    }
+    removed.moveToPos(3);
+    CHECK(removed.remove() == "item3");
+    removed.moveToStart();
+    CHECK(removed.remove() == "item0");
+    CHECK(cse204::to_string(removed) ==
+          "<| item1 item2 item4 item5 item6 item7>");
+  }
+
+  SECTION("Copies should keep the gap and the position") {
+    list.moveToPos(4);
+    list.remove();
+    cse204::GapBufferList<std::string> copy = list;
+    copy.insert("x");
+    CHECK(cse204::to_string(copy) == "<0 1 2 3 | x 5 6 7 8 9>");
+    CHECK(cse204::to_string(list) == "<0 1 2 3 | 5 6 7 8 9>");
+  }
+}
+
+TEST_CASE("Unrolled linked list nodes", "[UnrolledLinkedList]") {
+  // small nodes, so that every operation crosses node boundaries
+  cse204::UnrolledLinkedList<std::string, 4> list;
+  std::vector<std::string> expected;
+  for (int i = 0; i < 20; i++) {
+    list.append(std::to_string(i));
+    expected.push_back(std::to_string(i));
+  }
+
+  SECTION("Inserting into full nodes should split them") {
+    for (int pos : {0, 3, 4, 10, 21, 23}) {
+      list.moveToPos(pos);
+      list.insert("x" + std::to_string(pos));
+      expected.insert(expected.begin() + pos, "x" + std::to_string(pos));
+      CHECK(list.currPos() == pos);
+      CHECK(list.getValue() == "x" + std::to_string(pos));
+    }
+    CHECK(std::equal(list.begin(), list.end(), expected.begin(),
+                     expected.end()));
+    CHECK(list.Search("x21") == 21);
+  }
+
+  SECTION("Removing should keep order and position") {
+    for (int pos : {5, 5, 5, 0, 14, 13, 7}) {
+      list.moveToPos(pos);
+      CHECK(list.remove() == expected[pos]);
+      expected.erase(expected.begin() + pos);
+      size_t curr = std::min<size_t>(pos, expected.size() - 1);
+      CHECK(list.currPos() == curr);
+      CHECK(list.getValue() == expected[curr]);
+    }
+    CHECK(std::equal(list.begin(), list.end(), expected.begin(),
+                     expected.end()));
+
+    // walk back and forth across every node
+    list.moveToEnd();
+    for (size_t i = expected.size(); i-- > 0; list.prev()) {
+      CHECK(list.getValue() == expected[i]);
+    }
+    for (size_t i = 0; i < expected.size(); i++, list.next()) {
+      CHECK(list.getValue() == expected[i]);
+    }
+  }
+
+  SECTION("Removing every element should empty list") {
+    list.moveToPos(10);
+    while (list.length() > 0) {
+      list.remove();
+    }
+    CHECK(cse204::to_string(list) == "<>");
+    list.insert("a");
+    CHECK(cse204::to_string(list) == "<| a>");
+  }
+}
+
+TEST_CASE("Indexed skip list positions", "[IndexedSkipList]") {
+  cse204::IndexedSkipList<int> list;
+  std::vector<int> expected;
+  // deterministic pseudo random positions
+  unsigned seed = 1;
+  auto random = [&](size_t n) {
+    seed = seed * 1103515245 + 12345;
+    return (seed >> 8) % n;
+  };
+
+  for (int i = 0; i < 2000; i++) {
+    size_t pos = expected.empty() ? 0 : random(expected.size());
+    if (!expected.empty()) {
+      list.moveToPos(pos);
+    }
+    list.insert(i);
+    expected.insert(expected.begin() + pos, i);
+    REQUIRE(list.currPos() == pos);
+  }
+  REQUIRE(std::equal(list.begin(), list.end(), expected.begin(),
+                     expected.end()));
+
+  SECTION("Seeking should find every position") {
+    for (size_t pos = 0; pos < expected.size(); pos += 7) {
+      list.moveToPos(pos);
+      CHECK(list.getValue() == expected[pos]);
+    }
+    list.moveToEnd();
+    CHECK(list.getValue() == expected.back());
+    list.prev();
+    CHECK(list.getValue() == expected[expected.size() - 2]);
+  }
+
+  SECTION("Removing at random positions should keep order") {
+    while (expected.size() > 1) {
+      size_t pos = random(expected.size());
+      list.moveToPos(pos);
+      REQUIRE(list.remove() == expected[pos]);
+      expected.erase(expected.begin() + pos);
+      size_t curr = std::min(pos, expected.size() - 1);
+      REQUIRE(list.currPos() == curr);
+      REQUIRE(list.getValue() == expected[curr]);
+    }
+    CHECK(cse204::to_string(list) == "<| " + std::to_string(expected[0]) +
+                                         ">");
+    list.remove();
+    CHECK(cse204::to_string(list) == "<>");
+  }
+}
+
+/* Allocator that fails to allocate the level links of skip list nodes while
+ * LinkAllocation::fail is set */
+struct LinkAllocation {
+  inline static bool fail = false;
+};
+
+template <class T> struct LinkFailingAllocator : std::allocator<T> {
+  template <class U> struct rebind {
+    using other = LinkFailingAllocator<U>;
+  };
+
+  LinkFailingAllocator() = default;
+  template <class U> LinkFailingAllocator(const LinkFailingAllocator<U> &) {}
+
+  T *allocate(std::size_t n) {
+    if constexpr (requires(T link) { link.width; }) {
+      if (LinkAllocation::fail) {
+        throw std::bad_alloc();
+      }
+    }
+    return std::allocator<T>::allocate(n);
+  }
+};
+
+TEST_CASE("Indexed skip list allocation failure", "[IndexedSkipList]") {
+  LiveCounter::live = 0;
+  {
+    cse204::IndexedSkipList<LiveCounter, LinkFailingAllocator<LiveCounter>>
+        list;
+    LinkAllocation::fail = true;
+    int failures = 0;
+    for (int i = 0; i < 100; i++) {
+      try {
+        list.append(i);
+      } catch (const std::bad_alloc &) {
+        failures++;
+      }
+    }
+    LinkAllocation::fail = false;
+    // nodes taller than one level fail, their elements must be destroyed
+    CHECK(failures > 0);
+    CHECK(list.length() == 100 - failures);
+    CHECK(LiveCounter::live == list.length());
+  }
+  CHECK(LiveCounter::live == 0);
+}
+
+static_assert(cse204::ListADT<cse204::ArrayList<int>>);
+static_assert(cse204::ListADT<cse204::LinkedList<std::string>>);
+static_assert(cse204::ListADT<cse204::PooledLinkedList<int>>);
+static_assert(cse204::ListADT<cse204::GapBufferList<std::string>>);
+static_assert(cse204::ListADT<cse204::UnrolledLinkedList<std::string>>);
+static_assert(cse204::ListADT<cse204::IndexedSkipList<std::string>>);
+
+static_assert(std::contiguous_iterator<cse204::ArrayList<int>::iterator>);
+static_assert(std::contiguous_iterator<cse204::ArrayList<int>::const_iterator>);
+static_assert(std::forward_iterator<cse204::LinkedList<int>::iterator>);
+static_assert(std::forward_iterator<cse204::LinkedList<int>::const_iterator>);
+static_assert(std::ranges::random_access_range<const cse204::ArrayList<int>>);
+static_assert(std::ranges::forward_range<const cse204::LinkedList<int>>);
+static_assert(std::forward_iterator<cse204::GapBufferList<int>::iterator>);
+static_assert(std::ranges::forward_range<const cse204::GapBufferList<int>>);
+static_assert(std::forward_iterator<cse204::UnrolledLinkedList<int>::iterator>);
+static_assert(
+    std::ranges::forward_range<const cse204::UnrolledLinkedList<int>>);
+
+/* Persistent lists share their elements, so they only have const iterators */
+TEMPLATE_PRODUCT_TEST_CASE(
+    "List iterators",
+    "[ArrayList][LinkedList][PooledLinkedList][GapBufferList]"
+    "[UnrolledLinkedList][IndexedSkipList][SmallArrayList]",
+    (ArrayList, cse204::LinkedList, cse204::PooledLinkedList,
+     cse204::GapBufferList, UnrolledLinkedList, cse204::IndexedSkipList,
+     SmallArrayList),
+    (int)) {
+  TestType list = {3, 1, 4, 1, 5};
+  list.moveToPos(2);
+
+  SECTION("Range for should visit every element in order") {
+    std::vector<int> items;
+    for (int item : list) {
+      items.push_back(item);
+    }
+    CHECK(items == std::vector<int>{3, 1, 4, 1, 5});
+    CHECK(list.currPos() == 2);
+  }
+
+  SECTION("Const lists should be printable and comparable") {
+    const TestType &const_list = list;
+    const TestType other = {3, 1, 4, 1, 5};
+    CHECK(cse204::to_string(const_list) == "<3 1 | 4 1 5>");
+    CHECK(const_list == other);
+    CHECK(const_list.currPos() == 2);
+
+    TestType different = {3, 1, 4, 1};
+    CHECK_FALSE(const_list == different);
+    different.append(6);
+    CHECK_FALSE(const_list == different);
+  }
+
+  SECTION("Algorithms should work on lists") {
+    CHECK(std::count(list.begin(), list.end(), 1) == 2);
+    CHECK(*std::ranges::max_element(list) == 5);
+    CHECK(std::ranges::find(list, 7) == list.end());
+
+    std::ranges::replace(list, 1, 9);
+    CHECK(cse204::to_string(list) == "<3 9 | 4 9 5>");
+  }
+
+  SECTION("Empty lists should have empty ranges") {
+    TestType empty;
+    CHECK(empty.begin() == empty.end());
+    CHECK(std::ranges::distance(empty) == 0);
+  }
+}
+
+TEST_CASE("ArrayList random access iterators", "[ArrayList]") {
+  cse204::ArrayList<int> list = {3, 1, 4, 1, 5};
+  std::ranges::sort(list);
+  CHECK(cse204::to_string(list) == "<| 1 1 3 4 5>");
+  CHECK(list.end() - list.begin() == 5);
+  CHECK(list.begin()[2] == 3);
+}
+
+TEMPLATE_TEST_CASE("ArrayList vectorised search", "[ArrayList]", char, short,
+                   int, long long, float, double, std::string) {
+  auto value = [](int i) {
+    if constexpr (std::same_as<TestType, std::string>) {
+      return std::to_string(i);
+    } else {
+      return static_cast<TestType>(i);
+    }
+  };
+
+  // long enough to cover whole vectors and a scalar tail
+  cse204::ArrayList<TestType> list;
+  for (int i = 0; i < 103; i++) {
+    list.append(value(i % 50));
+  }
+
+  SECTION("Search should find the first occurence") {
+    CHECK(list.Search(value(0)) == 0);
+    CHECK(list.Search(value(49)) == 49);
+    CHECK(list.Search(value(2)) == 2);
+    CHECK(list.Search(value(99)) == -1);
+  }
+
+  SECTION("Search should find elements in the tail") {
+    list.append(value(77));
+    CHECK(list.Search(value(77)) == 103);
+  }
+
+  SECTION("SearchAll should find every occurence in order") {
+    auto positions = list.SearchAll(value(1));
+    CHECK(cse204::to_string(positions) == "<| 1 51 101>");
+    CHECK(list.SearchAll(value(99)).length() == 0);
+  }
+
+  SECTION("Count should count every occurence") {
+    CHECK(list.count(value(0)) == 3);
+    CHECK(list.count(value(2)) == 3);
+    CHECK(list.count(value(3)) == 2);
+    CHECK(list.count(value(99)) == 0);
+  }
+}
+
+TEST_CASE("ArrayList vectorised search of floating point values",
+          "[ArrayList]") {
+  cse204::ArrayList<double> list;
+  for (int i = 0; i < 20; i++) {
+    list.append(i);
+  }
+  list.append(-0.0);
+  list.append(std::numeric_limits<double>::quiet_NaN());
+
+  CHECK(list.Search(0.0) == 0);
+  CHECK(list.count(0.0) == 2);
+  CHECK(list.Search(std::numeric_limits<double>::quiet_NaN()) == -1);
+}
+
+TEMPLATE_PRODUCT_TEST_CASE(
+    "List equality",
+    "[ArrayList][LinkedList][PooledLinkedList][GapBufferList]"
+    "[UnrolledLinkedList][IndexedSkipList][SmallArrayList][PersistentList]",
+    (ArrayList, cse204::LinkedList, cse204::PooledLinkedList,
+     cse204::GapBufferList, UnrolledLinkedList, cse204::IndexedSkipList,
+     SmallArrayList, cse204::PersistentList),
+    (int, std::string)) {
+  using T = typename TestType::value_type;
+  TestType a = {T(), T(), T()};
+  TestType b = a;
+  a.moveToPos(1);
+  b.moveToEnd();
+
+  SECTION("Equal lists should compare equal without moving positions") {
+    CHECK(a == b);
+    CHECK_FALSE(a != b);
+    CHECK(TestType() == TestType());
+    CHECK(a.currPos() == 1);
+    CHECK(b.currPos() == 2);
+  }
+
+  SECTION("Lists differing in an element or length should not be equal") {
+    b.moveToStart();
+    b.remove();
+    CHECK_FALSE(a == b);
+    b.append(T());
+    CHECK(a == b);
+    a.moveToStart();
+    a.insert(a.getValue());
+    a.moveToEnd();
+    a.remove();
+    CHECK(a == b);
+    CHECK(a.currPos() == 2);
+  }
+
+  SECTION("Comparing through the List interface should restore positions") {
+    cse204::List<T> &ra = a, &rb = b;
+    TestType empty;
+    cse204::List<T> &re = empty;
+    // Catch decomposes comparisons into const operands, compare outside it
+    bool equal = ra == rb, self_equal = re == re, with_empty = ra == re;
+    CHECK(equal);
+    CHECK(self_equal);
+    CHECK_FALSE(with_empty);
+    b.moveToPos(1);
+    b.remove();
+    equal = ra == rb;
+    CHECK_FALSE(equal);
+    CHECK(a.currPos() == 1);
+    CHECK(b.currPos() == 1);
+  }
+}
+
+/* Allocator that is only equal to its copies, it records which one
+ * allocated each block so a block freed by another one can be detected */
+template <class T> struct OwnerAllocator {
+  using value_type = T;
+  inline static std::map<void *, int> owners;
+  inline static int next_owner = 0;
+
+  int owner;
+
+  OwnerAllocator() : owner(next_owner++) {}
+  template <class U>
+  OwnerAllocator(const OwnerAllocator<U> &other) : owner(other.owner) {}
+
+  T *allocate(std::size_t n) {
+    T *p = std::allocator<T>().allocate(n);
+    owners[p] = owner;
+    return p;
+  }
+
+  void deallocate(T *p, std::size_t n) {
+    CHECK(owners[p] == owner);
+    owners.erase(p);
+    std::allocator<T>().deallocate(p, n);
+  }
+
+  template <class U> bool operator==(const OwnerAllocator<U> &other) const {
+    return owner == other.owner;
+  }
+};
+
+TEMPLATE_TEST_CASE(
+    "Array list move assignment", "[ArrayList][SmallArrayList]",
+    (cse204::ArrayList<std::string, OwnerAllocator<std::string>>),
+    (cse204::SmallArrayList<std::string, 4, OwnerAllocator<std::string>>)) {
+  SECTION("Arrays should be freed by the allocator that created them") {
+    {
+      TestType a, b, small;
+      for (int i = 0; i < 20; i++) {
+        a.append(std::to_string(i));
+        b.append(std::to_string(i + 20));
+      }
+      small.append("x");
+      // both on the heap
+      a = std::move(b);
+      CHECK(a.length() == 20);
+      CHECK(a.getValue() == "20");
+      // inline, if there is inline storage, taking over a heap array
+      small = std::move(a);
+      CHECK(small.length() == 20);
+      for (int i = 0; i < 20; i++) {
+        a.append(std::to_string(i));
+        b.append(std::to_string(i));
+        small.append(std::to_string(i));
+      }
+    }
+    CHECK(OwnerAllocator<std::string>::owners.empty());
+  }
+}
+
+TEMPLATE_TEST_CASE(
+    "Gap buffer list move assignment", "[GapBufferList]",
+    (cse204::GapBufferList<std::string, OwnerAllocator<std::string>>),
+    (cse204::GapBufferList<std::string, cse204::PoolAllocator<std::string>>)) {
+  SECTION("Arrays should be freed by the allocator that created them") {
+    {
+      // capacity 1 arrays come out of the pool of a PoolAllocator
+      TestType a(1), b(1);
+      a.append("a");
+      b.append("b");
+      a = std::move(b);
+      CHECK(cse204::to_string(a) == "<| b>");
+      CHECK(b.length() == 0);
+      for (int i = 0; i < 20; i++) {
+        a.append(std::to_string(i));
+        b.append(std::to_string(i));
+      }
+      b = std::move(a);
+      CHECK(b.length() == 21);
+      CHECK(b.getValue() == "b");
+    }
+    CHECK(OwnerAllocator<std::string>::owners.empty());
+  }
+}
+
+TEST_CASE("Array list equality", "[ArrayList]") {
+  SECTION("Bitwise comparable elements") {
+    cse204::ArrayList<int> a = {1, 2, 3, 4, 5};
+    cse204::ArrayList<int, cse204::PoolAllocator<int>> b = {1, 2, 3, 4, 5};
+    CHECK(a == b);
+    b.moveToEnd();
+    b.remove();
+    b.append(6);
+    CHECK_FALSE(a == b);
+  }
+
+  SECTION("Floating point elements should compare by value") {
+    cse204::ArrayList<double> a = {0.0, 1.5};
+    cse204::ArrayList<double> b = {-0.0, 1.5};
+    CHECK(a == b);
+    cse204::ArrayList<double> nan = {std::numeric_limits<double>::quiet_NaN()};
+    CHECK_FALSE(nan == nan);
+  }
+}
+
+TEMPLATE_PRODUCT_TEST_CASE("Binary serialization",
+                           "[ArrayList][LinkedList][PooledLinkedList]",
+                           (ArrayList, cse204::LinkedList,
+                            cse204::PooledLinkedList),
+                           (int, std::string)) {
+  using T = typename TestType::value_type;
+  TestType list;
+  for (int i = 0; i < 10000; i++) {
+    if constexpr (std::same_as<T, std::string>) {
+      list.append(std::to_string(i));
+    } else {
+      list.append(i);
+    }
+  }
+  list.moveToPos(1234);
+  std::stringstream stream;
+  list.serialize(stream);
+
+  SECTION("Deserializing should restore elements and position") {
+    TestType restored = {T(), T()};
+    restored.deserialize(stream);
+    CHECK(restored == list);
+    CHECK(restored.currPos() == 1234);
+  }
+
+  SECTION("Array and linked lists should share the format") {
+    cse204::ArrayList<T> array;
+    array.deserialize(stream);
+    CHECK(std::equal(array.begin(), array.end(), list.begin(), list.end()));
+    std::stringstream again;
+    array.serialize(again);
+    cse204::LinkedList<T> linked;
+    linked.deserialize(again);
+    CHECK(std::equal(linked.begin(), linked.end(), list.begin(), list.end()));
+    CHECK(linked.currPos() == 1234);
+  }
+
+  SECTION("Empty lists should round trip") {
+    std::stringstream empty_stream;
+    TestType().serialize(empty_stream);
+    list.deserialize(empty_stream);
+    CHECK(list.length() == 0);
+    CHECK(cse204::to_string(list) == "<>");
+  }
+
+  SECTION("Truncated input should throw") {
+    std::string data = stream.str();
+    std::stringstream truncated(data.substr(0, data.size() - 1));
+    TestType restored;
+    CHECK_THROWS_AS(restored.deserialize(truncated), std::runtime_error);
+    std::stringstream header_only(data.substr(0, 4));
+    CHECK_THROWS_AS(restored.deserialize(header_only), std::runtime_error);
+  }
+}
+
+TEMPLATE_PRODUCT_TEST_CASE("Fast text writer",
+                           "[ArrayList][LinkedList][PooledLinkedList]",
+                           (ArrayList, cse204::LinkedList,
+                            cse204::PooledLinkedList),
+                           (int, std::string, double)) {
+  using T = typename TestType::value_type;
+  TestType list;
+  std::ostringstream fast;
+  cse204::write_text(fast, list);
+  CHECK(fast.str() == "<>");
+
+  for (int i = -5; i < 3000; i++) {
+    if constexpr (std::same_as<T, std::string>) {
+      list.append(std::to_string(i));
+    } else {
+      list.append(T(i) / 2);
+    }
+  }
+  list.moveToPos(17);
+  fast.str("");
+  cse204::write_text(fast, list);
+  CHECK(fast.str() == cse204::to_string(list));
+}
+
+TEMPLATE_PRODUCT_TEST_CASE("Bulk operations",
+                           "[ArrayList][LinkedList][PooledLinkedList]",
+                           (ArrayList, cse204::LinkedList,
+                            cse204::PooledLinkedList),
+                           (int)) {
+  TestType list = {0, 1, 2, 3, 4};
+  std::vector<int> items = {7, 8, 9};
+
+  SECTION("Insert range should insert at current position") {
+    list.moveToPos(2);
+    list.insert(items.begin(), items.end());
+    CHECK(cse204::to_string(list) == "<0 1 | 7 8 9 2 3 4>");
+    CHECK(list.length() == 8);
+
+    list.moveToEnd();
+    list.insert(items.begin(), items.end());
+    CHECK(cse204::to_string(list) == "<0 1 7 8 9 2 3 | 7 8 9 4>");
+    list.moveToEnd();
+    CHECK(list.getValue() == 4);
+
+    list.moveToStart();
+    list.insert(items.begin(), items.begin());
+    CHECK(list.length() == 11);
+  }
+
+  SECTION("Insert range longer than the shifted elements") {
+    std::vector<int> many(20, 5);
+    list.moveToEnd();
+    list.insert(many.begin(), many.end());
+    CHECK(list.length() == 25);
+    CHECK(std::count(list.begin(), list.end(), 5) == 20);
+    list.moveToEnd();
+    CHECK(list.getValue() == 4);
+  }
+
+  SECTION("Insert range into empty list") {
+    TestType empty;
+    empty.insert(items.begin(), items.end());
+    CHECK(cse204::to_string(empty) == "<| 7 8 9>");
+    empty.moveToEnd();
+    CHECK(empty.remove() == 9);
+    CHECK(cse204::to_string(empty) == "<7 | 8>");
+  }
+
+  SECTION("Insert from single pass range") {
+    std::istringstream in("5 6");
+    list.moveToPos(1);
+    list.insert(std::istream_iterator<int>(in), std::istream_iterator<int>());
+    CHECK(cse204::to_string(list) == "<0 | 5 6 1 2 3 4>");
+  }
+
+  SECTION("Append range should append at the end") {
+    list.moveToPos(1);
+    list.append(items);
+    CHECK(cse204::to_string(list) == "<0 | 1 2 3 4 7 8 9>");
+    list.moveToEnd();
+    CHECK(list.remove() == 9);
+    CHECK(list.getValue() == 8);
+
+    TestType empty;
+    empty.append(std::vector<int>{1});
+    empty.append(std::vector<int>{});
+    empty.append(items);
+    CHECK(cse204::to_string(empty) == "<| 1 7 8 9>");
+    empty.moveToEnd();
+    empty.prev();
+    CHECK(empty.getValue() == 8);
+  }
+
+  SECTION("Remove count should remove from current position") {
+    list.moveToPos(1);
+    list.remove(2);
+    CHECK(cse204::to_string(list) == "<0 | 3 4>");
+    list.remove(0);
+    CHECK(list.length() == 3);
+    list.moveToEnd();
+    CHECK(list.remove() == 4);
+    CHECK(cse204::to_string(list) == "<0 | 3>");
+  }
+
+  SECTION("Remove count up to the end should move back position") {
+    list.moveToPos(2);
+    list.remove(3);
+    CHECK(cse204::to_string(list) == "<0 | 1>");
+    CHECK(list.remove() == 1);
+    CHECK(cse204::to_string(list) == "<| 0>");
+  }
+
+  SECTION("Remove count of every element should empty list") {
+    list.remove(5);
+    CHECK(list.length() == 0);
+    CHECK(cse204::to_string(list) == "<>");
+    list.append(1);
+    CHECK(cse204::to_string(list) == "<| 1>");
+  }
+
+  SECTION("Remove count beyond the end should throw") {
+    list.moveToPos(3);
+    CHECK_THROWS_AS(list.remove(3), std::runtime_error);
+    CHECK(list.length() == 5);
+  }
+}
+
+TEMPLATE_PRODUCT_TEST_CASE("Bulk operations on non-trivial elements",
+                           "[ArrayList][LinkedList][PooledLinkedList]",
+                           (ArrayList, cse204::LinkedList,
+                            cse204::PooledLinkedList),
+                           (std::string)) {
+  TestType list = {"a", "b", "c", "d", "e"};
+  std::vector<std::string> items = {"x", "y"};
+
+  SECTION("Remove count should keep the remaining elements") {
+    list.moveToPos(1);
+    list.remove(0);
+    CHECK(cse204::to_string(list) == "<a | b c d e>");
+    list.remove(2);
+    CHECK(cse204::to_string(list) == "<a | d e>");
+    list.insert(items.begin(), items.end());
+    CHECK(cse204::to_string(list) == "<a | x y d e>");
+    list.moveToPos(3);
+    list.remove(2);
+    CHECK(cse204::to_string(list) == "<a x | y>");
+  }
+}
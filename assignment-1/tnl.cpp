@@ -1,9 +1,18 @@
 #include "arraylist.h"
+#include "gapbufferlist.h"
+#include "indexedskiplist.h"
 #include "linkedlist.h"
 
+#include <bit>
+#include <cstdint>
+#include <cstring>
 #include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
 
 #include "console_helper.h"
+#include "fast_io.h"
 
 class TNLStop {
 
@@ -42,29 +51,35 @@ requires ImplementsList<list_type>
 class TNL {
   list_type<std::shared_ptr<TNLStop>> m_list;
 
+  cse204::FastReader &m_in;
+  cse204::FastWriter &m_out;
+
 public:
+  TNL(cse204::FastReader &in, cse204::FastWriter &out)
+      : m_in(in), m_out(out) {}
+
   void process() {
     int K, L, M, T;
-    std::cin >> K;
+    m_in >> K;
     for (int i = 0; i < K; i++) {
       m_list.append(std::make_shared<TNLStop>(true));
     }
 
-    std::cin >> L;
+    m_in >> L;
     for (int i = 0, B; i < L; i++) {
-      std::cin >> B;
+      m_in >> B;
       m_list.moveToPos(B);
       m_list.getValue()->setBS(true);
     }
 
-    std::cin >> M;
+    m_in >> M;
     for (int i = 0, T; i < M; i++) {
-      std::cin >> T;
+      m_in >> T;
       m_list.moveToPos(T);
       m_list.getValue()->setTS(true);
     }
 
-    std::cin >> T;
+    m_in >> T;
     switch (T) {
     case 1:
       task1();
@@ -77,51 +92,165 @@ public:
   void task1() {
     m_list.moveToStart();
     for (int i = 0; i < m_list.length(); i++, m_list.next()) {
-      auto stop = m_list.getValue();
+      const auto &stop = m_list.getValue();
       if (stop->isRS()) {
-        std::cout << i;
+        m_out << i;
       }
       if (i < m_list.length() - 1) {
-        std::cout << ',';
+        m_out << ',';
       }
     }
-    std::cout << std::endl;
+    m_out << '\n';
 
     m_list.moveToStart();
     for (int i = 0; i < m_list.length(); i++, m_list.next()) {
-      auto stop = m_list.getValue();
+      const auto &stop = m_list.getValue();
       if (stop->isBS()) {
-        std::cout << i;
+        m_out << i;
       }
       if (i < m_list.length() - 1) {
-        std::cout << ',';
+        m_out << ',';
       }
     }
-    std::cout << std::endl;
+    m_out << '\n';
 
     m_list.moveToStart();
     for (int i = 0; i < m_list.length(); i++, m_list.next()) {
-      auto stop = m_list.getValue();
+      const auto &stop = m_list.getValue();
       if (stop->isTS()) {
-        std::cout << i;
+        m_out << i;
       }
       if (i < m_list.length() - 1) {
-        std::cout << ',';
+        m_out << ',';
       }
     }
-    std::cout << std::endl;
+    m_out << '\n';
+  }
+};
+
+/* Stops stored as one bitset per kind of transport, so a stop takes three
+ * bits instead of a heap allocated TNLStop */
+class TNLStopTable {
+  using word_t = std::uint64_t;
+  static constexpr int k_word_bits = 64;
+
+  int m_stops = 0;
+  std::vector<word_t> m_rickshaw;
+  std::vector<word_t> m_bus;
+  std::vector<word_t> m_train;
+
+  cse204::FastReader &m_in;
+  cse204::FastWriter &m_out;
+
+  void set(std::vector<word_t> &bits, int i) {
+    if (i < 0 || i >= m_stops) {
+      throw std::runtime_error("Attempt to access a stop beyond the last one.");
+    }
+    bits[i / k_word_bits] |= word_t(1) << (i % k_word_bits);
+  }
+
+  /* Appends the indices of the set bits of word w to line, separated by the
+   * commas between consecutive stops. last is the index of the last stop
+   * written so far, -1 before the first. */
+  static void append_word(std::string &line, int &last, word_t word, int w) {
+    while (word) {
+      int i = w * k_word_bits + std::countr_zero(word);
+      line.append(i - (last < 0 ? 0 : last), ',');
+      line.append(std::to_string(i));
+      last = i;
+      word &= word - 1;
+    }
+  }
+
+public:
+  TNLStopTable(cse204::FastReader &in, cse204::FastWriter &out)
+      : m_in(in), m_out(out) {}
+
+  void process() {
+    int K, L, M, T;
+    m_in >> K;
+    m_stops = K;
+    int words = (K + k_word_bits - 1) / k_word_bits;
+    // every stop has rickshaws
+    m_rickshaw.assign(words, ~word_t(0));
+    if (K % k_word_bits) {
+      m_rickshaw.back() = (word_t(1) << (K % k_word_bits)) - 1;
+    }
+    m_bus.assign(words, 0);
+    m_train.assign(words, 0);
+
+    m_in >> L;
+    for (int i = 0, B; i < L; i++) {
+      m_in >> B;
+      set(m_bus, B);
+    }
+
+    m_in >> M;
+    for (int i = 0, T; i < M; i++) {
+      m_in >> T;
+      set(m_train, T);
+    }
+
+    m_in >> T;
+    switch (T) {
+    case 1:
+      task1();
+      break;
+    default:
+      break;
+    }
+  }
+
+  /* Same output as TNL::task1, with all three lines built in one pass over
+   * the bitsets */
+  void task1() {
+    std::string lines[3];
+    int last[3] = {-1, -1, -1};
+    for (int w = 0; w < int(m_rickshaw.size()); w++) {
+      append_word(lines[0], last[0], m_rickshaw[w], w);
+      append_word(lines[1], last[1], m_bus[w], w);
+      append_word(lines[2], last[2], m_train[w], w);
+    }
+    for (int k = 0; k < 3; k++) {
+      // commas after the last stop written
+      if (m_stops > 0) {
+        lines[k].append(m_stops - 1 - (last[k] < 0 ? 0 : last[k]), ',');
+      }
+      m_out << lines[k] << '\n';
+    }
   }
 };
 
 int main(int argc, char **argv) {
+  if (argc > 1 && (std::strcmp(argv[1], "-bits") == 0 ||
+                   std::strcmp(argv[1], "--bitset") == 0)) {
+    cse204::FastReader in(std::cin);
+    cse204::FastWriter out(std::cout);
+    TNLStopTable(in, out).process();
+    return 0;
+  }
+
   auto list_type = selectListImplementation(argc, argv);
-  if (list_type.has_value()) {
+  if (!list_type.has_value()) {
+    std::cout << "-bits, --bitset\tTo store the stops in bitsets instead of a "
+                 "list"
+              << std::endl
+              << std::endl;
+  } else {
+    cse204::FastReader in(std::cin);
+    cse204::FastWriter out(std::cout);
     switch (list_type.value()) {
     case ListImplementationType::LINKED_LIST:
-      TNL<cse204::LinkedList>().process();
+      TNL<cse204::LinkedList>(in, out).process();
       break;
     case ListImplementationType::ARRAY_LIST:
-      TNL<cse204::ArrayList>().process();
+      TNL<cse204::ArrayList>(in, out).process();
+      break;
+    case ListImplementationType::GAP_BUFFER_LIST:
+      TNL<cse204::GapBufferList>(in, out).process();
+      break;
+    case ListImplementationType::SKIP_LIST:
+      TNL<cse204::IndexedSkipList>(in, out).process();
       break;
     }
   }
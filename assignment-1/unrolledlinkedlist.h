@@ -0,0 +1,562 @@
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <concepts>
+#include <cstring>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+
+#include "list.h"
+#include "simd_search.h"
+
+namespace cse204 {
+
+/* Linked list whose nodes hold up to NodeCapacity elements in an array.
+ * Traversal and search run over contiguous elements most of the time, and
+ * inserting or removing only shifts elements within a single node. Nodes are
+ * kept at least half full, except for the last one, by merging with or
+ * borrowing from the following node after a remove. */
+template <class T, std::size_t NodeCapacity = 32,
+          class Allocator = std::allocator<T>>
+class UnrolledLinkedList final : public List<T> {
+  static_assert(NodeCapacity >= 2, "Nodes must be able to split in two");
+
+  using typename List<T>::size_t;
+  using List<T>::npos;
+
+  struct node {
+    node *next = nullptr;
+    node *prev = nullptr;
+    size_t count = 0;
+    /* only items[0, count) are constructed */
+    union {
+      T items[NodeCapacity];
+    };
+
+    node() {}
+    ~node() {}
+  };
+
+  using allocator_type =
+      typename std::allocator_traits<Allocator>::template rebind_alloc<node>;
+  using allocator_traits =
+      typename std::allocator_traits<Allocator>::template rebind_traits<node>;
+
+  allocator_type m_allocator;
+
+  /* first and last node, nullptr if list is empty */
+  node *m_head;
+  node *m_tail;
+  /* node containing the current element and its index within the node */
+  node *m_curr;
+  size_t m_offset;
+
+  size_t m_length;
+  size_t m_pos;
+
+/* Run some assertions to check validity of state. */
+#define CHECK_STATE()                                                          \
+  if (m_length == 0) {                                                         \
+    assert(!m_head && !m_tail && !m_curr);                                     \
+    assert(m_pos == 0 && m_offset == 0);                                       \
+  } else {                                                                     \
+    assert(m_head && m_tail && m_curr);                                        \
+    assert(m_offset < m_curr->count);                                          \
+    assert(m_pos < m_length);                                                  \
+    assert(m_pos >= m_offset);                                                 \
+  }
+
+public:
+  /* Create empty list. */
+  UnrolledLinkedList()
+      : m_head(nullptr), m_tail(nullptr), m_curr(nullptr), m_offset(0),
+        m_length(0), m_pos(0) {}
+
+  /* Create list from initialiser list */
+  UnrolledLinkedList(std::initializer_list<T> items)
+      : UnrolledLinkedList(items.size(), items.begin()) {}
+
+  /* Create list with data from static array */
+  template <size_t N>
+  UnrolledLinkedList(T const (&items)[N]) : UnrolledLinkedList(N, items) {}
+
+  /* Create list with pointer data */
+  UnrolledLinkedList(size_t num_items, T const *items) : UnrolledLinkedList() {
+    for (size_t i = 0; i < num_items; i++) {
+      append(items[i]);
+    }
+    CHECK_STATE();
+  }
+
+  /* Copy constructor: copies elements from another list */
+  UnrolledLinkedList(const UnrolledLinkedList &other) requires std::copyable<T>
+      : UnrolledLinkedList() {
+    copy_from(other);
+    CHECK_STATE();
+  }
+
+  /* Move constructor: steals elements from another list */
+  UnrolledLinkedList(UnrolledLinkedList &&other)
+      : m_allocator(std::move(other.m_allocator)), m_head(other.m_head),
+        m_tail(other.m_tail), m_curr(other.m_curr), m_offset(other.m_offset),
+        m_length(other.m_length), m_pos(other.m_pos) {
+    other.m_head = other.m_tail = other.m_curr = nullptr;
+    other.m_offset = other.m_length = other.m_pos = 0;
+    CHECK_STATE();
+  }
+
+  /* Copy assignment: copies elements from another list */
+  UnrolledLinkedList &operator=(const UnrolledLinkedList &other)
+    requires std::copyable<T>
+  {
+    if (this == &other) {
+      return *this;
+    }
+    clear();
+    copy_from(other);
+    CHECK_STATE();
+    return *this;
+  }
+
+  /* Move assignment: steals elements from another list */
+  UnrolledLinkedList &operator=(UnrolledLinkedList &&other) {
+    if (this == &other) {
+      return *this;
+    }
+    clear();
+    // nodes can only be deallocated by the allocator that owns them
+    std::swap(m_allocator, other.m_allocator);
+    std::swap(m_head, other.m_head);
+    std::swap(m_tail, other.m_tail);
+    std::swap(m_curr, other.m_curr);
+    std::swap(m_offset, other.m_offset);
+    std::swap(m_length, other.m_length);
+    std::swap(m_pos, other.m_pos);
+    CHECK_STATE();
+    return *this;
+  }
+
+  /* Destructor */
+  ~UnrolledLinkedList() { clear(); }
+
+private:
+  /* helper methods */
+
+  /* Allocates an empty node and links it after prev, or at the start of the
+   * list if prev is nullptr */
+  node *create_node(node *prev) {
+    node *p = allocator_traits::allocate(m_allocator, 1);
+    allocator_traits::construct(m_allocator, p);
+    p->prev = prev;
+    p->next = prev ? prev->next : m_head;
+    if (p->next) {
+      p->next->prev = p;
+    } else {
+      m_tail = p;
+    }
+    if (prev) {
+      prev->next = p;
+    } else {
+      m_head = p;
+    }
+    return p;
+  }
+
+  /* Unlinks and deallocates a node, its elements must already be destroyed */
+  void delete_node(node *p) {
+    assert(p->count == 0);
+    if (p->prev) {
+      p->prev->next = p->next;
+    } else {
+      m_head = p->next;
+    }
+    if (p->next) {
+      p->next->prev = p->prev;
+    } else {
+      m_tail = p->prev;
+    }
+    allocator_traits::destroy(m_allocator, p);
+    allocator_traits::deallocate(m_allocator, p, 1);
+  }
+
+  /* Constructs an element in uninitialised memory of a node */
+  template <class... R> void construct(T *p, R &&...params) {
+    allocator_traits::construct(m_allocator, p, std::forward<R>(params)...);
+  }
+
+  /* Moves count elements from src to dst, which is uninitialised unless it
+   * overlaps src. Sources are destroyed. Safe for overlapping ranges. */
+  void relocate(T *dst, T *src, size_t count) {
+    if constexpr (std::is_trivially_copyable_v<T>) {
+      std::memmove(static_cast<void *>(dst), src, count * sizeof(T));
+    } else if (dst < src) {
+      for (size_t i = 0; i < count; i++) {
+        construct(dst + i, std::move(src[i]));
+        allocator_traits::destroy(m_allocator, src + i);
+      }
+    } else {
+      for (size_t i = count; i-- > 0;) {
+        construct(dst + i, std::move(src[i]));
+        allocator_traits::destroy(m_allocator, src + i);
+      }
+    }
+  }
+
+  /* Moves the upper half of a full node into a new node following it */
+  void split(node *p) {
+    assert(p->count == NodeCapacity);
+    constexpr size_t half = NodeCapacity / 2;
+    node *q = create_node(p);
+    relocate(q->items, p->items + half, NodeCapacity - half);
+    q->count = NodeCapacity - half;
+    p->count = half;
+  }
+
+  /* Refills a node that has become less than half full from the following
+   * node, merging the two if they fit together */
+  void rebalance(node *p) {
+    node *q = p->next;
+    if (!q || p->count >= NodeCapacity / 2) {
+      return;
+    }
+    if (p->count + q->count <= NodeCapacity) {
+      relocate(p->items + p->count, q->items, q->count);
+      p->count += q->count;
+      q->count = 0;
+      delete_node(q);
+    } else {
+      relocate(p->items + p->count, q->items, 1);
+      relocate(q->items, q->items + 1, q->count - 1);
+      p->count++;
+      q->count--;
+    }
+  }
+
+  /* Copies elements of other list, which must be empty */
+  void copy_from(const UnrolledLinkedList &other) {
+    for (node *p = other.m_head; p; p = p->next) {
+      node *q = create_node(m_tail);
+      std::uninitialized_copy(p->items, p->items + p->count, q->items);
+      q->count = p->count;
+      if (p == other.m_curr) {
+        m_curr = q;
+      }
+    }
+    m_offset = other.m_offset;
+    m_length = other.m_length;
+    m_pos = other.m_pos;
+  }
+
+  /* Sets the current position at the start of the list */
+  inline void reset_position() {
+    m_curr = m_head;
+    m_offset = m_pos = 0;
+  }
+
+public:
+  /* Constructs element at current position from params. The node of the
+   * current element is split if it is full. */
+  template <class... R>
+  requires std::constructible_from<T, R...>
+  void emplace(R &&...params) {
+    CHECK_STATE();
+
+    if (m_length == 0) {
+      emplace_back(std::forward<R>(params)...);
+      return;
+    }
+    // params may refer to an element of this list, so construct before
+    // moving elements
+    T item(std::forward<R>(params)...);
+    if (m_curr->count == NodeCapacity) {
+      split(m_curr);
+      if (m_offset >= m_curr->count) {
+        m_offset -= m_curr->count;
+        m_curr = m_curr->next;
+      }
+    }
+    relocate(m_curr->items + m_offset + 1, m_curr->items + m_offset,
+             m_curr->count - m_offset);
+    construct(m_curr->items + m_offset, std::move(item));
+    m_curr->count++;
+    m_length++;
+
+    CHECK_STATE();
+  }
+
+  /* Constructs element at the end of the list from params. A new node is
+   * started when the last one is full. */
+  template <class... R>
+  requires std::constructible_from<T, R...>
+  void emplace_back(R &&...params) {
+    CHECK_STATE();
+
+    if (m_tail && m_tail->count < NodeCapacity) {
+      construct(m_tail->items + m_tail->count, std::forward<R>(params)...);
+    } else {
+      // params may refer to an element of this list, construct the element
+      // before linking the node so that nothing leaks if it throws
+      T item(std::forward<R>(params)...);
+      create_node(m_tail);
+      construct(m_tail->items, std::move(item));
+    }
+    m_tail->count++;
+    if (m_length++ == 0) {
+      reset_position();
+    }
+
+    CHECK_STATE();
+  }
+
+  /* List interface implementation */
+
+  /* Clear contents from the list, to make it empty. */
+  void clear() override {
+    while (m_head) {
+      for (size_t i = 0; i < m_head->count; i++) {
+        allocator_traits::destroy(m_allocator, m_head->items + i);
+      }
+      m_head->count = 0;
+      delete_node(m_head);
+    }
+    m_curr = nullptr;
+    m_offset = m_length = m_pos = 0;
+  }
+
+  /* Insert an element at the current location. */
+  void insert(const T &item) override { emplace(item); }
+
+  /* Insert an element at the current location by moving it. */
+  void insert(T &&item) override { emplace(std::move(item)); }
+
+  /* Append an element at the end of the list. */
+  void append(const T &item) override { emplace_back(item); }
+
+  /* Append an element at the end of the list by moving it. */
+  void append(T &&item) override { emplace_back(std::move(item)); }
+
+  /* Remove and return the current element. */
+  T remove() override {
+    CHECK_STATE();
+
+    if (m_length == 0) {
+      throw std::runtime_error("Attempt to remove from an empty list.");
+    }
+
+    T ret = std::move(m_curr->items[m_offset]);
+    allocator_traits::destroy(m_allocator, m_curr->items + m_offset);
+    relocate(m_curr->items + m_offset, m_curr->items + m_offset + 1,
+             m_curr->count - m_offset - 1);
+    m_curr->count--;
+    m_length--;
+
+    // find the element that followed the removed one
+    node *p = m_curr;
+    if (p->count == 0) {
+      p = p->next;
+      delete_node(m_curr);
+      m_offset = 0;
+    } else {
+      rebalance(p);
+      if (m_offset == p->count) {
+        p = p->next;
+        m_offset = 0;
+      }
+    }
+    m_curr = p;
+
+    if (m_length == 0) {
+      reset_position();
+    } else if (!m_curr) {
+      // removed the last element, current is the new last element
+      m_curr = m_tail;
+      m_offset = m_tail->count - 1;
+      m_pos--;
+    }
+
+    CHECK_STATE();
+    return ret;
+  }
+
+  /* Set the current position to the start of the list */
+  inline void moveToStart() override {
+    CHECK_STATE();
+    reset_position();
+  }
+
+  /* Set the current position to the end of the list */
+  inline void moveToEnd() override {
+    CHECK_STATE();
+    if (m_length > 0) {
+      m_curr = m_tail;
+      m_offset = m_tail->count - 1;
+      m_pos = m_length - 1;
+    }
+  }
+
+  /* Move the current position one step left. No change if already at
+   * beginning. */
+  void prev() override {
+    CHECK_STATE();
+    if (m_pos == 0) {
+      return;
+    }
+    if (m_offset == 0) {
+      m_curr = m_curr->prev;
+      m_offset = m_curr->count;
+    }
+    m_offset--;
+    m_pos--;
+  }
+
+  /* Move the current position one step right. No change if already at end. */
+  void next() override {
+    CHECK_STATE();
+    if (m_pos + 1 >= m_length) {
+      return;
+    }
+    if (++m_offset == m_curr->count) {
+      m_curr = m_curr->next;
+      m_offset = 0;
+    }
+    m_pos++;
+  }
+
+  /* Return the number of elements in the list. */
+  inline size_t length() const override {
+    CHECK_STATE();
+    return m_length;
+  }
+
+  /* Return the position of the current element. */
+  inline size_t currPos() const override {
+    CHECK_STATE();
+    return m_pos;
+  }
+
+  /* Set current position, skipping whole nodes from the closest of the
+   * start, the current node or the end. */
+  void moveToPos(size_t pos) override {
+    CHECK_STATE();
+
+    if (pos >= m_length) {
+      throw std::runtime_error(
+          "Attempt to move to position beyond the length of the list.");
+    }
+
+    // position of the first element of the node walked from
+    size_t start = m_pos - m_offset;
+    node *p = m_curr;
+    size_t from_curr = pos > start ? pos - start : start - pos;
+    size_t from_end = m_length - pos;
+    if (pos <= from_curr && pos <= from_end) {
+      p = m_head;
+      start = 0;
+    } else if (from_end < from_curr) {
+      p = m_tail;
+      start = m_length - m_tail->count;
+    }
+
+    while (pos >= start + p->count) {
+      start += p->count;
+      p = p->next;
+      assert(p);
+    }
+    while (pos < start) {
+      p = p->prev;
+      assert(p);
+      start -= p->count;
+    }
+    m_curr = p;
+    m_offset = pos - start;
+    m_pos = pos;
+  }
+
+  /* Return the current element. */
+  inline const T &getValue() const override {
+    CHECK_STATE();
+    if (m_length == 0) {
+      throw std::runtime_error(
+          "Attempt to get value of element from empty list.");
+    }
+    return m_curr->items[m_offset];
+  }
+
+  /* Search for an item in the list, returns npos ( (size_t) -1 ) if not found.
+   */
+  size_t Search(const T &item) const override {
+    size_t start = 0;
+    for (node *p = m_head; p; p = p->next) {
+      size_t i = simd::find(p->items, p->count, item);
+      if (i < p->count) {
+        return start + i;
+      }
+      start += p->count;
+    }
+    return npos;
+  }
+
+  /* Forward iterator over the elements, does not move the current position */
+  template <bool Const> class basic_iterator {
+    friend class UnrolledLinkedList;
+    friend class basic_iterator<!Const>;
+
+    using node_ptr = std::conditional_t<Const, const node *, node *>;
+
+    node_ptr m_node = nullptr;
+    size_t m_offset = 0;
+
+    explicit basic_iterator(node_ptr p) : m_node(p) {}
+
+  public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = T;
+    using difference_type = std::ptrdiff_t;
+    using pointer = std::conditional_t<Const, const T *, T *>;
+    using reference = std::conditional_t<Const, const T &, T &>;
+
+    basic_iterator() = default;
+
+    /* Mutable iterators convert to const iterators */
+    template <bool C>
+    requires(Const && !C) //
+    basic_iterator(const basic_iterator<C> &other)
+        : m_node(other.m_node), m_offset(other.m_offset) {}
+
+    reference operator*() const { return m_node->items[m_offset]; }
+    pointer operator->() const { return &m_node->items[m_offset]; }
+
+    basic_iterator &operator++() {
+      if (++m_offset == m_node->count) {
+        m_node = m_node->next;
+        m_offset = 0;
+      }
+      return *this;
+    }
+
+    basic_iterator operator++(int) {
+      basic_iterator ret = *this;
+      ++*this;
+      return ret;
+    }
+
+    bool operator==(const basic_iterator &other) const = default;
+  };
+
+  using iterator = basic_iterator<false>;
+  using const_iterator = basic_iterator<true>;
+
+  inline iterator begin() { return iterator(m_head); }
+  inline iterator end() { return iterator(); }
+  inline const_iterator begin() const { return const_iterator(m_head); }
+  inline const_iterator end() const { return const_iterator(); }
+  inline const_iterator cbegin() const { return begin(); }
+  inline const_iterator cend() const { return end(); }
+
+#undef CHECK_STATE
+};
+
+} // namespace cse204
@@ -0,0 +1,515 @@
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <concepts>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+#include "stack.h"
+
+namespace cse204 {
+
+/* Any number of stacks sharing one contiguous array. Stack i grows upwards
+ * in its own region of the array, the regions lying one after another.
+ *
+ * When a stack runs into the next region the free space is divided again
+ * among all of them (Garwick's algorithm): a tenth of it equally, the rest
+ * in proportion to how much each stack grew since the last time, so stacks
+ * that are growing get more room. The elements are moved to their new
+ * regions in place. The array is only reallocated, doubling in size, once
+ * less than an eighth of it would be left free.
+ *
+ * Elements move when the regions are rebalanced, so references to them are
+ * only valid until the next push, and moving must not throw. */
+template <typename T>
+requires std::is_nothrow_move_constructible_v<T>
+class MultiStackArena {
+public:
+  /* signed like the size type of the stacks */
+  using size_t = long long;
+
+private:
+  static constexpr size_t k_default_capacity = 8;
+
+  T *m_data;
+  size_t m_capacity;
+  /* stack i occupies [m_base[i], m_base[i + 1]), the last entry is the
+   * capacity */
+  std::vector<size_t> m_base;
+  std::vector<size_t> m_length;
+  /* lengths when the regions were last rebalanced */
+  std::vector<size_t> m_last_length;
+
+public:
+  /* Creates arena for stacks empty stacks, dividing capacity equally between
+   * them. Default capacity is k_default_capacity elements per stack. */
+  MultiStackArena(size_t stacks, size_t capacity = 0)
+      : m_base(std::max<size_t>(stacks, 0) + 1),
+        m_length(std::max<size_t>(stacks, 0)),
+        m_last_length(std::max<size_t>(stacks, 0)) {
+    if (stacks <= 0) {
+      throw std::runtime_error("Arena must hold at least one stack");
+    }
+    m_capacity = capacity > 0 ? capacity : stacks * k_default_capacity;
+    m_data = std::allocator<T>().allocate(m_capacity);
+    for (size_t i = 0; i <= stacks; i++) {
+      m_base[i] = m_capacity * i / stacks;
+    }
+  }
+
+  /* Stacks refer to the arena, so it cannot be copied or moved */
+  MultiStackArena(const MultiStackArena &) = delete;
+  MultiStackArena &operator=(const MultiStackArena &) = delete;
+
+  /* Destructor: destroys the elements of every stack */
+  ~MultiStackArena() {
+    clear();
+    std::allocator<T>().deallocate(m_data, m_capacity);
+  }
+
+private:
+  /* helper methods */
+
+  inline T *bottom(size_t i) { return m_data + m_base[i]; }
+  inline T *end(size_t i) { return bottom(i) + m_length[i]; }
+
+  /* Moves n elements from src to dst, which may overlap if dst is below src */
+  static void move_down(T *src, size_t n, T *dst) {
+    for (size_t k = 0; k < n; k++) {
+      std::construct_at(dst + k, std::move(src[k]));
+      std::destroy_at(src + k);
+    }
+  }
+
+  /* Moves n elements from src to dst, which may overlap if dst is above src */
+  static void move_up(T *src, size_t n, T *dst) {
+    for (size_t k = n - 1; k >= 0; k--) {
+      std::construct_at(dst + k, std::move(src[k]));
+      std::destroy_at(src + k);
+    }
+  }
+
+  /* Divides the array again so stack full has room for count more elements,
+   * doubling the array if too little would be left free */
+  void rebalance(size_t full, size_t count) {
+    const size_t n = stacks();
+    size_t used = count;
+    size_t growth = 0;
+    for (size_t i = 0; i < n; i++) {
+      size_t length = m_length[i] + (i == full ? count : 0);
+      used += m_length[i];
+      growth += std::max<size_t>(length - m_last_length[i], 0);
+    }
+
+    size_t capacity = m_capacity;
+    while (capacity - used < capacity / 8) {
+      capacity *= 2;
+    }
+
+    // a tenth of the free space is shared equally, the rest in proportion to
+    // growth, the last stack takes what is left by rounding down
+    const size_t free = capacity - used;
+    const size_t equal = free / 10 / n;
+    const size_t proportional = free - equal * n;
+    std::vector<size_t> base(n + 1);
+    for (size_t i = 0; i < n - 1; i++) {
+      size_t length = m_length[i] + (i == full ? count : 0);
+      size_t grown = std::max<size_t>(length - m_last_length[i], 0);
+      size_t share = growth > 0 ? proportional * grown / growth
+                                : proportional / n;
+      base[i + 1] = base[i] + length + equal + share;
+    }
+    base[n] = capacity;
+
+    if (capacity != m_capacity) {
+      T *data = std::allocator<T>().allocate(capacity);
+      for (size_t i = 0; i < n; i++) {
+        std::uninitialized_move(bottom(i), end(i), data + base[i]);
+        std::destroy(bottom(i), end(i));
+      }
+      std::allocator<T>().deallocate(m_data, m_capacity);
+      m_data = data;
+      m_capacity = capacity;
+    } else {
+      // stacks moving down go first, from the bottom, then the ones moving
+      // up, from the top, so none is moved onto elements not moved yet
+      for (size_t i = 0; i < n; i++) {
+        if (base[i] < m_base[i]) {
+          move_down(bottom(i), m_length[i], m_data + base[i]);
+        }
+      }
+      for (size_t i = n - 1; i >= 0; i--) {
+        if (base[i] > m_base[i]) {
+          move_up(bottom(i), m_length[i], m_data + base[i]);
+        }
+      }
+    }
+    m_base = std::move(base);
+    m_last_length = m_length;
+  }
+
+public:
+  /* Returns the number of stacks in the arena */
+  inline size_t stacks() const { return m_length.size(); }
+
+  /* Returns the number of elements the array can hold */
+  inline size_t capacity() const { return m_capacity; }
+
+  /* Returns size of stack i */
+  inline size_t length(size_t i) const { return m_length[i]; }
+
+  /* Returns the bottom element of stack i, the rest follow it up to the
+   * top */
+  inline T *data(size_t i) { return bottom(i); }
+
+  /* Returns the bottom element of stack i, the rest follow it up to the
+   * top */
+  inline const T *data(size_t i) const { return m_data + m_base[i]; }
+
+  /* Makes room for count more elements on stack i, returns where the first
+   * of them goes */
+  T *reserve(size_t i, size_t count) {
+    assert(i >= 0 && i < stacks());
+    if (m_base[i] + m_length[i] + count > m_base[i + 1]) {
+      rebalance(i, count);
+    }
+    return end(i);
+  }
+
+  /* Clear contents from stack i */
+  void clear(size_t i) {
+    std::destroy(bottom(i), end(i));
+    m_length[i] = 0;
+  }
+
+  /* Clear contents from every stack */
+  void clear() {
+    for (size_t i = 0; i < stacks(); i++) {
+      clear(i);
+    }
+  }
+
+  /* Constructs an element on the top of stack i from params */
+  template <class... R>
+  requires std::constructible_from<T, R...>
+  void emplace(size_t i, R &&...params) {
+    if (m_base[i] + m_length[i] == m_base[i + 1]) {
+      // params may refer to an element of a stack, so construct before
+      // rebalancing moves it
+      T item(std::forward<R>(params)...);
+      std::construct_at(reserve(i, 1), std::move(item));
+    } else {
+      std::construct_at(end(i), std::forward<R>(params)...);
+    }
+    m_length[i]++;
+  }
+
+  /* Pushes the elements of [first, last) on stack i in order. Rebalances at
+   * most once if the size of the range is known. The range must not refer
+   * to elements in the arena. */
+  template <std::input_iterator I>
+  requires std::constructible_from<T, std::iter_reference_t<I>>
+  void push_range(size_t i, I first, I last) {
+    if constexpr (!std::forward_iterator<I>) {
+      for (; first != last; ++first) {
+        emplace(i, *first);
+      }
+    } else {
+      size_t count = std::distance(first, last);
+      std::uninitialized_copy(first, last, reserve(i, count));
+      m_length[i] += count;
+    }
+  }
+
+  /* Pushes copies of the elements of stack from on stack to, bottom first.
+   * Room is made before the elements are read, as that may move them. */
+  void copy_stack(size_t from, size_t to) requires std::copyable<T> {
+    assert(from != to);
+    size_t count = m_length[from];
+    T *dst = reserve(to, count);
+    std::uninitialized_copy_n(bottom(from), count, dst);
+    m_length[to] += count;
+  }
+
+  /* Moves the elements of stack from on stack to, bottom first, leaving
+   * stack from empty. */
+  void move_stack(size_t from, size_t to) {
+    assert(from != to);
+    size_t count = m_length[from];
+    T *dst = reserve(to, count);
+    std::uninitialized_move_n(bottom(from), count, dst);
+    m_length[to] += count;
+    clear(from);
+  }
+
+  /* Pops item from the top of stack i and returns value */
+  T pop(size_t i) {
+    if (m_length[i] == 0) {
+      throw std::runtime_error("Attempt to pop from empty stack");
+    }
+    T *top = end(i) - 1;
+    T ret = std::move(*top);
+    std::destroy_at(top);
+    m_length[i]--;
+    return ret;
+  }
+
+  /* Removes the top count elements of stack i without returning them */
+  void pop(size_t i, size_t count) {
+    if (count < 0 || count > m_length[i]) {
+      throw std::runtime_error("Attempt to pop more elements than in stack");
+    }
+    std::destroy(end(i) - count, end(i));
+    m_length[i] -= count;
+  }
+
+  /* Moves every element of stack i to out, from the top down, leaving it
+   * empty. Returns the output iterator past the last element written. */
+  template <std::output_iterator<T &&> O> O pop_into(size_t i, O out) {
+    out = std::move(std::make_reverse_iterator(end(i)),
+                    std::make_reverse_iterator(bottom(i)), out);
+    clear(i);
+    return out;
+  }
+
+  /* Returns the value of the top element of stack i */
+  inline T &top(size_t i) {
+    if (m_length[i] == 0) {
+      throw std::runtime_error("Attempt to get top value from empty stack");
+    }
+    return end(i)[-1];
+  }
+
+  /* Returns the value of the top element of stack i */
+  inline const T &top(size_t i) const {
+    if (m_length[i] == 0) {
+      throw std::runtime_error("Attempt to get top value from empty stack");
+    }
+    return data(i)[m_length[i] - 1];
+  }
+};
+
+/* Stack stored in a MultiStackArena. A stack created without an arena gets
+ * an arena of its own, allocated on the first push.
+ *
+ * Copies and moved-from stacks get arenas of their own as well, while
+ * assignment replaces the elements in the arena the stack already uses.
+ * Elements left in a shared arena are destroyed by the arena. */
+template <typename T>
+requires std::is_nothrow_move_constructible_v<T>
+class ArenaStack : public Stack<T> {
+
+  using typename Stack<T>::size_t;
+
+  /* nullptr until an own arena is needed */
+  MultiStackArena<T> *m_arena;
+  size_t m_index;
+  std::unique_ptr<MultiStackArena<T>> m_own_arena;
+
+public:
+  /* Create empty stack. */
+  ArenaStack() : m_arena(nullptr), m_index(0) {}
+
+  /* Create stack from initialiser list */
+  ArenaStack(std::initializer_list<T> items) : ArenaStack() {
+    push_range(items.begin(), items.end());
+  }
+
+  /* Create stack on stack index of arena, which must outlive the stack */
+  ArenaStack(MultiStackArena<T> &arena, size_t index)
+      : m_arena(&arena), m_index(index) {
+    if (index < 0 || index >= arena.stacks()) {
+      throw std::runtime_error("Invalid stack index");
+    }
+  }
+
+  /* Copy constructor: copies elements from another stack */
+  ArenaStack(const ArenaStack &other) requires std::copyable<T>
+      : ArenaStack() {
+    copy_from(other);
+  }
+
+  /* Move constructor: takes over the stack of another */
+  ArenaStack(ArenaStack &&other) noexcept
+      : m_arena(other.m_arena), m_index(other.m_index),
+        m_own_arena(std::move(other.m_own_arena)) {
+    other.m_arena = nullptr;
+    other.m_index = 0;
+  }
+
+  /* Copy assignment: copies elements from another stack */
+  ArenaStack &operator=(const ArenaStack &other) requires std::copyable<T> {
+    if (same_stack(other)) {
+      return *this;
+    }
+    clear();
+    copy_from(other);
+    return *this;
+  }
+
+  /* Move assignment: swaps arenas if neither stack shares one, otherwise
+   * moves the elements over */
+  ArenaStack &operator=(ArenaStack &&other) {
+    if (same_stack(other)) {
+      return *this;
+    }
+    if (!is_shared() && !other.is_shared()) {
+      std::swap(m_arena, other.m_arena);
+      std::swap(m_index, other.m_index);
+      std::swap(m_own_arena, other.m_own_arena);
+    } else if (m_arena && m_arena == other.m_arena) {
+      clear();
+      m_arena->move_stack(other.m_index, m_index);
+    } else {
+      clear();
+      if (other.length() > 0) {
+        T *first = other.m_arena->data(other.m_index);
+        push_range(std::make_move_iterator(first),
+                   std::make_move_iterator(first + other.length()));
+      }
+    }
+    other.clear();
+    return *this;
+  }
+
+private:
+  /* helper methods */
+
+  inline bool is_shared() const { return m_arena && !m_own_arena; }
+
+  inline bool same_stack(const ArenaStack &other) const {
+    return m_arena == other.m_arena && m_index == other.m_index;
+  }
+
+  /* Returns the arena, creating an own one if there is none yet */
+  MultiStackArena<T> &arena() {
+    if (!m_arena) {
+      m_own_arena = std::make_unique<MultiStackArena<T>>(1);
+      m_arena = m_own_arena.get();
+      m_index = 0;
+    }
+    return *m_arena;
+  }
+
+  /* Assuming the stack is empty, copies the elements of other stack. The
+   * arena copies between its own stacks, as making room may move them. */
+  void copy_from(const ArenaStack &other) {
+    if (m_arena && m_arena == other.m_arena) {
+      m_arena->copy_stack(other.m_index, m_index);
+    } else if (other.length() > 0) {
+      const T *first = other.m_arena->data(other.m_index);
+      push_range(first, first + other.length());
+    }
+  }
+
+public:
+  /* Stack interface implementation. */
+
+  /* Clear contents from the stack, making it empty */
+  void clear() override {
+    if (m_arena) {
+      m_arena->clear(m_index);
+    }
+  }
+
+  /* Pushes item on the top of the stack */
+  void push(const T &item) override {
+    if constexpr (std::copyable<T>) {
+      arena().emplace(m_index, item);
+    }
+  }
+
+  /* Pushes item on the top of the stack */
+  void push(T &&item) override { arena().emplace(m_index, std::move(item)); }
+
+  /* Pops item from the top of the stack and returns value */
+  T pop() override {
+    if (length() == 0) {
+      throw std::runtime_error("Attempt to pop from empty stack");
+    }
+    return m_arena->pop(m_index);
+  }
+
+  /* Constructs an element on the top of the stack from params */
+  template <class... R>
+  requires std::constructible_from<T, R...>
+  void emplace(R &&...params) {
+    arena().emplace(m_index, std::forward<R>(params)...);
+  }
+
+  /* Pushes the elements of [first, last) in order, so the last one ends up on
+   * top. The range must not refer to elements in the arena. */
+  template <std::input_iterator I>
+  requires std::constructible_from<T, std::iter_reference_t<I>>
+  void push_range(I first, I last) {
+    arena().push_range(m_index, first, last);
+  }
+
+  /* Removes the top count elements without returning them */
+  void pop(size_t count) {
+    if (count < 0 || count > length()) {
+      throw std::runtime_error("Attempt to pop more elements than in stack");
+    }
+    if (count > 0) {
+      m_arena->pop(m_index, count);
+    }
+  }
+
+  /* Moves every element to out, from the top down, leaving the stack empty.
+   * Returns the output iterator past the last element written. */
+  template <std::output_iterator<T &&> O> O pop_into(O out) {
+    return m_arena ? m_arena->pop_into(m_index, out) : out;
+  }
+
+  /* Returns size of the stack */
+  inline size_t length() const override {
+    return m_arena ? m_arena->length(m_index) : 0;
+  }
+
+  /* Returns the value of the top element of the stack */
+  inline T &topValue() override {
+    if (length() == 0) {
+      throw std::runtime_error("Attempt to get top value from empty stack");
+    }
+    return m_arena->top(m_index);
+  }
+
+  /* Returns the value of the top element of the stack */
+  inline const T &topValue() const override {
+    if (length() == 0) {
+      throw std::runtime_error("Attempt to get top value from empty stack");
+    }
+    return m_arena->top(m_index);
+  }
+
+  /* Has no effect */
+  void setDirection(int) override {}
+};
+
+#ifndef CSE204_STACK_OUTPUT_STREAM_IMPLEMENTED
+#define CSE204_STACK_OUTPUT_STREAM_IMPLEMENTED
+template <typename T>
+std::ostream &operator<<(std::ostream &os, Stack<T> &stack) {
+  ArenaStack<T> temp;
+  while (stack.length() > 0) {
+    temp.push(std::move(stack.pop()));
+  }
+  os << '<';
+  while (temp.length() > 0) {
+    T v = temp.pop();
+    os << v;
+    if (temp.length() > 0) {
+      os << ", ";
+    }
+    stack.push(std::move(v));
+  }
+  os << '>';
+  return os;
+}
+#endif
+
+} // namespace cse204
@@ -2,7 +2,9 @@
 
 #include <algorithm>
 #include <concepts>
+#include <iterator>
 #include <memory>
+#include <stdexcept>
 
 #include "stack.h"
 
@@ -16,6 +18,8 @@ template <typename T> class ArrayStack : public Stack<T> {
   size_t m_capacity;
   size_t m_length;
 
+  /* Only the elements of the stack are constructed, rest of an owned array
+   * is uninitialised memory */
   T *m_data;
 
   bool m_owns_memory = true;
@@ -24,14 +28,15 @@ template <typename T> class ArrayStack : public Stack<T> {
 public:
   /* creates empty stack */
   ArrayStack(size_t initial_capacity = k_default_capacity)
-      : m_capacity(initial_capacity), m_length(0), m_data(new T[m_capacity]) {}
+      : m_capacity(initial_capacity), m_length(0),
+        m_data(allocate(m_capacity)) {}
 
   /* Create stack from initializer stack */
   ArrayStack(std::initializer_list<T> items,
              size_t initial_capacity = k_default_capacity)
       : m_capacity(initial_capacity), m_length(items.size()) {
     fit_and_allocate();
-    std::copy(items.begin(), items.end(), m_data);
+    std::uninitialized_copy(items.begin(), items.end(), m_data);
   }
 
   /* Create stack from array, but does not own it */
@@ -47,7 +52,7 @@ public:
   ArrayStack(const ArrayStack &other) requires std::copyable<T>
       : m_capacity(other.m_capacity),
         m_length(other.m_length),
-        m_data(new T[m_capacity]),
+        m_data(allocate(m_capacity)),
         m_owns_memory(true),
         m_dir(other.m_dir) {
     copy_from(other);
@@ -65,27 +70,27 @@ public:
     other.m_owns_memory = true;
   }
 
-  /* copy assignment: copies elements from other stack */
+  /* copy assignment: copies elements from other stack, keeping the
+   * direction of this one */
   ArrayStack &operator=(const ArrayStack &other) requires std::copyable<T> {
     if (this == &other) {
       return *this;
     }
 
+    if (m_capacity < other.m_length && !m_owns_memory) {
+      // only delete and resize if array owns memory
+      throw std::runtime_error(
+          "Assignment exceeds capacity of array provided at construction");
+    }
+    destroy_elements();
     m_length = other.m_length;
     if (m_capacity < other.m_length) {
-      // only delete and resize if array owns memory
-      if (!m_owns_memory) {
-        throw std::runtime_error(
-            "Assignment exceeds capacity of array provided at construction");
-      }
-      delete[] m_data;
+      deallocate();
       fit_and_allocate();
-    } else {
-      destroy_elements();
     }
 
+    // keep own direction, a stack on a borrowed array must stay on its end
     copy_from(other);
-    m_dir = other.m_dir;
     return *this;
   }
 
@@ -107,23 +112,48 @@ public:
     return *this;
   }
 
-  /* destructor */
+  /* destructor, elements left in an array that is not owned are destroyed
+   * by the owner of the array */
   ~ArrayStack() {
     if (m_owns_memory) {
-      delete[] m_data;
+      destroy_elements();
+      deallocate();
     }
   }
 
 private:
   /* helper methods */
 
-  /* Copies data from other stack, takes direction into account */
+  /* Allocates uninitialised memory for capacity elements */
+  static T *allocate(size_t capacity) {
+    return capacity > 0 ? std::allocator<T>().allocate(capacity) : nullptr;
+  }
+
+  /* Frees an owned array, elements must already be destroyed */
+  void deallocate() {
+    if (m_owns_memory && m_data) {
+      std::allocator<T>().deallocate(m_data, m_capacity);
+    }
+    m_data = nullptr;
+  }
+
+  /* First element in the array, the top of the stack for a reverse stack
+   * and the bottom otherwise */
+  inline T *begin_elements() {
+    return m_dir > 0 ? m_data : m_data + m_capacity - m_length;
+  }
+
+  /* Copies data from other stack into uninitialised memory, takes direction
+   * into account */
   void copy_from(const ArrayStack &other) {
-    if (other.m_dir > 0) {
-      std::copy(other.m_data, other.m_data + m_length, m_data);
+    const T *first = other.m_dir > 0
+                         ? other.m_data
+                         : other.m_data + other.m_capacity - other.m_length;
+    if (m_dir == other.m_dir) {
+      std::uninitialized_copy_n(first, m_length, begin_elements());
     } else {
-      std::copy(other.m_data + other.m_capacity - other.m_length,
-                other.m_data + other.m_capacity, m_data);
+      std::uninitialized_copy_n(std::make_reverse_iterator(first + m_length),
+                                m_length, begin_elements());
     }
   }
 
@@ -131,40 +161,55 @@ private:
    * to that capacity */
   void fit_and_allocate() {
     assert(m_owns_memory);
+    if (m_capacity == 0) {
+      m_capacity = k_default_capacity;
+    }
     while (m_capacity < m_length) {
       m_capacity *= 2;
     }
-    m_data = new T[m_capacity];
+    m_data = allocate(m_capacity);
   }
 
-  /* expands internal data array size by the chuck size
-   * and copying data to it */
-  void expand() {
+  /* expands internal data array to hold at least count more elements,
+   * doubling its size, and moves data to it */
+  void expand(size_t count = 1) {
     if (!m_owns_memory) {
       throw std::runtime_error(
           "Operation exceeds capacity of array provided at construction");
     }
-    if (m_capacity == 0) {
-      m_capacity = k_default_capacity;
-    }
-    auto old_data = m_data;
-    m_capacity *= 2;
-    m_data = new T[m_capacity];
+    size_t new_capacity = m_capacity > 0 ? m_capacity : k_default_capacity;
+    do {
+      new_capacity *= 2;
+    } while (new_capacity < m_length + count);
+    T *new_data = allocate(new_capacity);
+    T *first = begin_elements();
     if (m_dir > 0) {
-      std::move(old_data, old_data + m_length, m_data);
+      std::uninitialized_move(first, first + m_length, new_data);
     } else {
-      std::move(old_data, old_data + m_length, m_data + m_length);
+      std::uninitialized_move(first, first + m_length,
+                              new_data + new_capacity - m_length);
     }
-    delete[] old_data;
+    std::destroy(first, first + m_length);
+    deallocate();
+    m_capacity = new_capacity;
+    m_data = new_data;
   }
 
   /* destruct all elements */
   void destroy_elements() {
+    T *first = begin_elements();
+    std::destroy(first, first + m_length);
+  }
+
+  /* Destroys the top count elements */
+  void destroy_top(size_t count) {
     if (m_dir > 0) {
-      std::destroy(m_data, m_data + m_length);
+      std::destroy(m_data + m_length - count, m_data + m_length);
     } else {
-      std::destroy(m_data + m_capacity - m_length, m_data + m_capacity);
+      T *top = m_data + m_capacity - m_length;
+      std::destroy(top, top + count);
     }
+    m_length -= count;
   }
 
   /* returns position in the array of the element at the top of the stack */
@@ -226,6 +271,73 @@ public:
     return ret;
   }
 
+  /* Constructs an element on the top of the stack from params */
+  template <class... R>
+  requires std::constructible_from<T, R...>
+  void emplace(R &&...params) {
+    if (m_length >= m_capacity) {
+      // params may refer to an element of this stack, so construct before
+      // expanding
+      T item(std::forward<R>(params)...);
+      expand();
+      std::construct_at(m_data + next_array_pos(), std::move(item));
+    } else {
+      std::construct_at(m_data + next_array_pos(),
+                        std::forward<R>(params)...);
+    }
+    m_length++;
+  }
+
+  /* Pushes the elements of [first, last) in order, so the last one ends up on
+   * top. Expands at most once and constructs all of them with a single
+   * uninitialised copy if the size of the range is known. The range must not
+   * refer to elements of this stack. */
+  template <std::input_iterator I>
+  requires std::constructible_from<T, std::iter_reference_t<I>>
+  void push_range(I first, I last) {
+    if constexpr (!std::forward_iterator<I>) {
+      for (; first != last; ++first) {
+        emplace(*first);
+      }
+    } else {
+      size_t count = std::distance(first, last);
+      if (m_length + count > m_capacity) {
+        expand(count);
+      }
+      if (m_dir > 0) {
+        std::uninitialized_copy(first, last, m_data + m_length);
+      } else {
+        // elements grow downwards, the first one goes to the highest address
+        T *end = m_data + m_capacity - m_length;
+        std::uninitialized_copy(first, last, std::make_reverse_iterator(end));
+      }
+      m_length += count;
+    }
+  }
+
+  /* Removes the top count elements without returning them */
+  void pop(size_t count) {
+    if (count < 0 || count > m_length) {
+      throw std::runtime_error("Attempt to pop more elements than in stack");
+    }
+    destroy_top(count);
+  }
+
+  /* Moves every element to out, from the top down, leaving the stack empty.
+   * Returns the output iterator past the last element written. */
+  template <std::output_iterator<T &&> O> O pop_into(O out) {
+    T *first = begin_elements();
+    if (m_dir > 0) {
+      out = std::move(std::make_reverse_iterator(first + m_length),
+                      std::make_reverse_iterator(first), out);
+    } else {
+      out = std::move(first, first + m_length, out);
+    }
+    destroy_elements();
+    m_length = 0;
+    return out;
+  }
+
   /* Returns size of the stack */
   inline size_t length() const override { return m_length; }
 
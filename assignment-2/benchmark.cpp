@@ -0,0 +1,205 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <vector>
+
+#include "arraystack.h"
+#include "concurrentstack.h"
+#include "linkedstack.h"
+#include "segmentedstack.h"
+
+template <class... R, class T>
+void print_comma_seperated(std::ostream &os, T &&a, R &&...rest) {
+  os << a;
+  if constexpr (sizeof...(rest)) {
+    os << ',';
+    print_comma_seperated(os, rest...);
+  } else {
+    os << std::endl;
+  }
+}
+
+// time of each of N pushes onto an empty stack in nanoseconds, sorted
+template <template <typename> typename stack_type>
+std::vector<float> push_latencies(int N) {
+  stack_type<int> stack;
+  std::vector<float> latencies(N);
+  for (int i = 0; i < N; i++) {
+    auto start = std::chrono::steady_clock::now();
+    stack.push(i);
+    latencies[i] = (std::chrono::steady_clock::now() - start).count();
+  }
+  std::sort(latencies.begin(), latencies.end());
+  return latencies;
+}
+
+// latency below which the given fraction of the sorted latencies fall
+float percentile(const std::vector<float> &latencies, double fraction) {
+  return latencies[std::min(latencies.size() - 1,
+                            size_t(latencies.size() * fraction))];
+}
+
+template <template <typename> typename stack_type>
+void print_latencies(std::ostream &out, int n, const char *name) {
+  auto latencies = push_latencies<stack_type>(n);
+  print_comma_seperated(out, n, name, percentile(latencies, 0.5),
+                        percentile(latencies, 0.99),
+                        percentile(latencies, 0.999), latencies.back());
+}
+
+void benchmark_push_latency(std::ostream &out) {
+  int N[] = {10000, 100000, 1000000, 10000000};
+  print_comma_seperated(out, ' ', ' ', ' ', ' ', ' ',
+                        "Push latency in ns");
+  print_comma_seperated(out, 'n', "Stack", "Median", "99th Percentile",
+                        "99.9th Percentile", "Maximum");
+
+  for (int n : N) {
+    print_latencies<cse204::ArrayStack>(out, n, "ArrayStack");
+    print_latencies<cse204::SegmentedStack>(out, n, "SegmentedStack");
+  }
+}
+
+// allocator counting calls to allocate through any of its rebinds
+inline long long allocation_count = 0;
+
+template <class T> struct CountingAllocator : std::allocator<T> {
+  template <class U> struct rebind {
+    using other = CountingAllocator<U>;
+  };
+
+  CountingAllocator() = default;
+  template <class U> CountingAllocator(const CountingAllocator<U> &) {}
+
+  T *allocate(std::size_t n) {
+    allocation_count++;
+    return std::allocator<T>::allocate(n);
+  }
+};
+
+template <class T>
+using CountedLinkedStack = cse204::LinkedStack<T, CountingAllocator<T>>;
+template <class T>
+using CountedPooledLinkedStack =
+    cse204::PooledLinkedStack<T, CountingAllocator<T>>;
+
+// time per push or pop in nanoseconds and allocations per push, pushing and
+// popping burst elements at a time on a stack holding depth elements, after
+// one round to warm up
+template <template <typename> typename stack_type>
+std::pair<float, float> churn(int depth, int burst, int rounds) {
+  stack_type<int> stack;
+  for (int i = 0; i < depth + burst; i++) {
+    stack.push(i);
+  }
+  stack.pop(burst);
+
+  allocation_count = 0;
+  auto start = std::chrono::steady_clock::now();
+  for (int r = 0; r < rounds; r++) {
+    for (int i = 0; i < burst; i++) {
+      stack.push(i);
+    }
+    for (int i = 0; i < burst; i++) {
+      stack.pop();
+    }
+  }
+  float time = (std::chrono::steady_clock::now() - start).count();
+  float pushes = float(rounds) * burst;
+  return {time / (2 * pushes), allocation_count / pushes};
+}
+
+template <template <typename> typename stack_type>
+void print_churn(std::ostream &out, int burst, const char *name) {
+  const int operations = 10000000;
+  auto [time, allocations] = churn<stack_type>(1000, burst, operations / burst);
+  print_comma_seperated(out, burst, name, time, allocations);
+}
+
+void benchmark_churn(std::ostream &out) {
+  int bursts[] = {1, 16, 256, 4096};
+  print_comma_seperated(out, ' ', ' ', "Push/pop churn on 1000 elements");
+  print_comma_seperated(out, "Burst", "Stack", "Time per operation in ns",
+                        "Allocations per push");
+
+  for (int burst : bursts) {
+    print_churn<CountedLinkedStack>(out, burst, "LinkedStack");
+    print_churn<CountedPooledLinkedStack>(out, burst, "PooledLinkedStack");
+  }
+}
+
+// stack guarded by a mutex, with the interface of ConcurrentStack
+struct LockedStack {
+  std::mutex mutex;
+  cse204::PooledLinkedStack<int> stack;
+
+  void push(int item) {
+    std::lock_guard lock(mutex);
+    stack.push(item);
+  }
+
+  std::optional<int> try_pop() {
+    std::lock_guard lock(mutex);
+    if (stack.length() == 0) {
+      return std::nullopt;
+    }
+    return stack.pop();
+  }
+};
+
+// millions of elements per second passing through the stack while the given
+// number of producers push N ints in total and as many consumers pop them
+template <class stack_type> float mpmc_rate(int N, int threads) {
+  stack_type stack;
+  std::atomic<int> popped = 0;
+  auto start = std::chrono::steady_clock::now();
+  std::vector<std::thread> workers;
+  for (int t = 0; t < threads; t++) {
+    workers.emplace_back([&]() {
+      for (int i = 0; i < N / threads; i++) {
+        stack.push(i);
+      }
+    });
+    workers.emplace_back([&]() {
+      while (popped.load(std::memory_order_relaxed) < N / threads * threads) {
+        if (stack.try_pop()) {
+          popped.fetch_add(1, std::memory_order_relaxed);
+        }
+      }
+    });
+  }
+  for (auto &worker : workers) {
+    worker.join();
+  }
+  std::chrono::duration<float, std::micro> time =
+      std::chrono::steady_clock::now() - start;
+  return N / time.count();
+}
+
+void benchmark_mpmc(std::ostream &out) {
+  const int N = 4000000;
+  int threads[] = {1, 2, 4, 8};
+  print_comma_seperated(out, ' ', ' ', "Million elements per second");
+  print_comma_seperated(out, "Producers and consumers", "ConcurrentStack",
+                        "Locked LinkedStack");
+  for (int t : threads) {
+    print_comma_seperated(out, t, mpmc_rate<cse204::ConcurrentStack<int>>(N, t),
+                          mpmc_rate<LockedStack>(N, t));
+  }
+}
+
+int main() {
+  std::ofstream latency_file("latency.csv");
+  benchmark_push_latency(latency_file);
+  std::ofstream churn_file("churn.csv");
+  benchmark_churn(churn_file);
+  std::ofstream mpmc_file("mpmc.csv");
+  benchmark_mpmc(mpmc_file);
+  return 0;
+}
@@ -0,0 +1,246 @@
+#pragma once
+
+#include <atomic>
+#include <bit>
+#include <cassert>
+#include <concepts>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <type_traits>
+
+namespace cse204 {
+
+/* Lock-free stack (Treiber stack) that any number of threads can push to and
+ * pop from at the same time, for example to share a pool of work.
+ *
+ * Nodes are stored in segments that double in size and are only freed with
+ * the stack. A popped node goes onto a free list of the same kind and is
+ * reused by later pushes. The top of the stack and of the free list are each
+ * a single 64 bit word holding the index of a node and a tag that changes on
+ * every update, so a compare and swap cannot succeed on a top that was popped
+ * and pushed again in between (the ABA problem). Since nodes are never freed,
+ * reading a node that another thread just popped is still safe.
+ *
+ * Only push, emplace, try_pop and empty are thread-safe. clear and the
+ * destructor must not run while other threads use the stack, and the
+ * allocator must be safe to use from several threads at once. The stack
+ * holds at most 2^32 - 32 elements at a time. */
+template <class T, class Allocator = std::allocator<T>>
+requires std::is_nothrow_move_constructible_v<T>
+class ConcurrentStack {
+public:
+  using size_t = std::size_t;
+  using value_type = T;
+
+private:
+  using index_t = std::uint32_t;
+
+  /* index of no node, ends the chains */
+  static constexpr index_t k_none = ~index_t(0);
+
+  /* first segment holds 2^k_first_segment_bits nodes */
+  static constexpr size_t k_first_segment_bits = 5;
+  static constexpr size_t k_first_segment_size = size_t(1)
+                                                 << k_first_segment_bits;
+  static constexpr size_t k_max_segments = 32 - k_first_segment_bits;
+  /* number of nodes the segments hold together, less than k_none */
+  static constexpr size_t k_max_nodes =
+      k_first_segment_size * ((size_t(1) << k_max_segments) - 1);
+
+  struct node {
+    /* node below this one, may be read by a thread that lost the race to pop
+     * this node */
+    std::atomic<index_t> next;
+    /* constructed while the node is on the stack */
+    union {
+      T value;
+    };
+
+    node() : next(k_none) {}
+    ~node() {}
+  };
+
+  using allocator_type =
+      typename std::allocator_traits<Allocator>::template rebind_alloc<node>;
+  using allocator_traits =
+      typename std::allocator_traits<Allocator>::template rebind_traits<node>;
+
+  allocator_type m_allocator;
+
+  /* segment s holds k_first_segment_size << s nodes, nullptr until one of
+   * them is needed */
+  std::atomic<node *> m_segments[k_max_segments] = {};
+  /* number of nodes handed out, the rest of the segments are unused */
+  std::atomic<size_t> m_created = 0;
+  /* tagged tops of the stack and of the free list */
+  std::atomic<std::uint64_t> m_top = pack(k_none, 0);
+  std::atomic<std::uint64_t> m_free = pack(k_none, 0);
+
+  static_assert(std::atomic<std::uint64_t>::is_always_lock_free);
+
+  /* a tagged top holds the tag in the upper and the index in the lower half */
+  static inline constexpr std::uint64_t pack(index_t index,
+                                             std::uint64_t tag) {
+    return tag << 32 | index;
+  }
+
+  static inline index_t index_of(std::uint64_t top) { return index_t(top); }
+
+  static inline std::uint64_t tag_of(std::uint64_t top) { return top >> 32; }
+
+  static inline size_t segment_size(size_t segment) {
+    return k_first_segment_size << segment;
+  }
+
+  /* segment of an index, and the index within that segment */
+  static inline size_t segment_of(size_t i) {
+    return std::bit_width(i + k_first_segment_size) - 1 - k_first_segment_bits;
+  }
+
+  static inline size_t offset_of(size_t i, size_t segment) {
+    return i + k_first_segment_size - segment_size(segment);
+  }
+
+  inline node &node_at(index_t i) const {
+    size_t s = segment_of(i);
+    return m_segments[s].load(std::memory_order_acquire)[offset_of(i, s)];
+  }
+
+  /* Returns segment s, allocating it if no other thread has yet */
+  node *get_segment(size_t s) {
+    node *segment = m_segments[s].load(std::memory_order_acquire);
+    if (segment) {
+      return segment;
+    }
+    node *created = allocator_traits::allocate(m_allocator, segment_size(s));
+    for (size_t i = 0; i < segment_size(s); i++) {
+      allocator_traits::construct(m_allocator, created + i);
+    }
+    if (m_segments[s].compare_exchange_strong(segment, created,
+                                              std::memory_order_acq_rel)) {
+      return created;
+    }
+    // another thread installed its segment first
+    free_segment(created, s);
+    return segment;
+  }
+
+  void free_segment(node *segment, size_t s) {
+    for (size_t i = 0; i < segment_size(s); i++) {
+      allocator_traits::destroy(m_allocator, segment + i);
+    }
+    allocator_traits::deallocate(m_allocator, segment, segment_size(s));
+  }
+
+  /* Links node i on top of the chain starting at top */
+  void link(std::atomic<std::uint64_t> &top, index_t i) {
+    node &n = node_at(i);
+    std::uint64_t old = top.load(std::memory_order_relaxed);
+    do {
+      n.next.store(index_of(old), std::memory_order_relaxed);
+    } while (!top.compare_exchange_weak(old, pack(i, tag_of(old) + 1),
+                                        std::memory_order_release,
+                                        std::memory_order_relaxed));
+  }
+
+  /* Unlinks the top node of the chain starting at top, returns k_none if the
+   * chain is empty. The tag makes the exchange fail if the top was popped
+   * and pushed again since next was read. */
+  index_t unlink(std::atomic<std::uint64_t> &top) {
+    std::uint64_t old = top.load(std::memory_order_acquire);
+    while (index_of(old) != k_none) {
+      index_t next =
+          node_at(index_of(old)).next.load(std::memory_order_relaxed);
+      if (top.compare_exchange_weak(old, pack(next, tag_of(old) + 1),
+                                    std::memory_order_acquire,
+                                    std::memory_order_acquire)) {
+        return index_of(old);
+      }
+    }
+    return k_none;
+  }
+
+  /* Returns a node that no other thread uses, recycled if possible */
+  index_t acquire_node() {
+    index_t i = unlink(m_free);
+    if (i != k_none) {
+      return i;
+    }
+    size_t created = m_created.fetch_add(1, std::memory_order_relaxed);
+    if (created >= k_max_nodes) {
+      m_created.fetch_sub(1, std::memory_order_relaxed);
+      throw std::runtime_error("Concurrent stack is full");
+    }
+    size_t s = segment_of(created);
+    assert(s < k_max_segments);
+    get_segment(s);
+    return index_t(created);
+  }
+
+public:
+  /* Create empty stack */
+  ConcurrentStack() = default;
+
+  ConcurrentStack(const ConcurrentStack &) = delete;
+  ConcurrentStack &operator=(const ConcurrentStack &) = delete;
+
+  ~ConcurrentStack() {
+    clear();
+    for (size_t s = 0; s < k_max_segments; s++) {
+      if (node *segment = m_segments[s].load()) {
+        free_segment(segment, s);
+      }
+    }
+  }
+
+  /* Constructs an element on the top of the stack from params. A throwing
+   * constructor leaves the stack unchanged. */
+  template <class... R>
+  requires std::constructible_from<T, R...>
+  void emplace(R &&...params) {
+    index_t i = acquire_node();
+    node &n = node_at(i);
+    try {
+      ::new (std::addressof(n.value)) T(std::forward<R>(params)...);
+    } catch (...) {
+      link(m_free, i);
+      throw;
+    }
+    link(m_top, i);
+  }
+
+  /* Pushes copy of item on the top of the stack */
+  void push(const T &item) { emplace(item); }
+
+  /* Pushes item on the top of the stack by moving it */
+  void push(T &&item) { emplace(std::move(item)); }
+
+  /* Pops item from the top of the stack and returns value, or returns
+   * nothing if the stack is empty */
+  std::optional<T> try_pop() {
+    index_t i = unlink(m_top);
+    if (i == k_none) {
+      return std::nullopt;
+    }
+    node &n = node_at(i);
+    std::optional<T> ret(std::move(n.value));
+    std::destroy_at(std::addressof(n.value));
+    link(m_free, i);
+    return ret;
+  }
+
+  /* Whether the stack was empty at some point during the call */
+  bool empty() const {
+    return index_of(m_top.load(std::memory_order_acquire)) == k_none;
+  }
+
+  /* Destroys every element, keeping the nodes for reuse. Not thread-safe. */
+  void clear() {
+    while (try_pop()) {
+    }
+  }
+};
+
+} // namespace cse204
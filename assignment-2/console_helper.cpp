@@ -12,6 +12,12 @@ std::optional<StackImplementationType> selectStackImplementation(int argc,
     } else if (std::strcmp(argv[1], "-arr2") == 0 ||
                std::strcmp(argv[1], "--array2stack") == 0) {
       return StackImplementationType::ARRAY2STACK;
+    } else if (std::strcmp(argv[1], "-seg") == 0 ||
+               std::strcmp(argv[1], "--segmentedstack") == 0) {
+      return StackImplementationType::SEGMENTED_STACK;
+    } else if (std::strcmp(argv[1], "-arena") == 0 ||
+               std::strcmp(argv[1], "--arenastack") == 0) {
+      return StackImplementationType::ARENA_STACK;
     }
   }
 
@@ -27,6 +33,12 @@ std::optional<StackImplementationType> selectStackImplementation(int argc,
             << "-arr2, --array2stack\t(Only Applicable for the Dishwasher "
                "problem) Test the stacks with a single array container"
             << std::endl
+            << "-seg, --segmentedstack\tTo test the block based "
+               "implementation of the stack interface"
+            << std::endl
+            << "-arena, --arenastack\tTo test the stacks sharing a single "
+               "growing array"
+            << std::endl
             << std::endl;
   return std::nullopt;
 }
@@ -6,7 +6,13 @@
 
 #include "stack.h"
 
-enum class StackImplementationType { ARRAY_STACK, LINKED_STACK, ARRAY2STACK };
+enum class StackImplementationType {
+  ARRAY_STACK,
+  LINKED_STACK,
+  ARRAY2STACK,
+  SEGMENTED_STACK,
+  ARENA_STACK
+};
 
 template <template <typename> typename R>
 concept ImplementsStack = std::derived_from<R<int>, cse204::Stack<int>>; 
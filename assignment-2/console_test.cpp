@@ -2,8 +2,10 @@
 #include <cstring>
 #include <iostream>
 
+#include "arenastack.h"
 #include "arraystack.h"
 #include "linkedstack.h"
+#include "segmentedstack.h"
 
 #include "console_helper.h"
 
@@ -71,6 +73,12 @@ int main(int argc, char **argv) {
     case StackImplementationType::ARRAY_STACK:
       StackTester(cse204::ArrayStack<int>()).test();
       break;
+    case StackImplementationType::SEGMENTED_STACK:
+      StackTester(cse204::SegmentedStack<int>()).test();
+      break;
+    case StackImplementationType::ARENA_STACK:
+      StackTester(cse204::ArenaStack<int>()).test();
+      break;
     case StackImplementationType::ARRAY2STACK:
       std::cout << "Array 2 Stack only applicable for the dishwasher problem"
                 << std::endl;
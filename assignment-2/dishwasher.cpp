@@ -1,10 +1,13 @@
 #include <iostream>
 #include <limits>
 
+#include "arenastack.h"
 #include "arraystack.h"
 #include "linkedstack.h"
+#include "segmentedstack.h"
 
 #include "console_helper.h"
+#include "fast_io.h"
 
 struct Dish {
   int time_pushed;
@@ -22,11 +25,16 @@ class DishwasherSimulator {
 
   int time = 0;
 
+  cse204::FastReader &m_in;
+  cse204::FastWriter &m_out;
+
 public:
   DishwasherSimulator(stack_type<Dish> &&dirty_stack,
-                      stack_type<Dish> &&clean_stack, int n, int x)
+                      stack_type<Dish> &&clean_stack, int n, int x,
+                      cse204::FastReader &in, cse204::FastWriter &out)
       : m_dirty_stack(std::move(dirty_stack)),
-        m_clean_stack(std::move(clean_stack)), n(n), x(x) {}
+        m_clean_stack(std::move(clean_stack)), n(n), x(x), m_in(in),
+        m_out(out) {}
 
   void cleanDish() {
     // start washing dish when cleaning last dish finished or the dish was
@@ -46,10 +54,10 @@ public:
       temp.push(m_clean_stack.pop());
     }
     while (temp.length()) {
-      std::cout << temp.topValue().time_pushed;
+      m_out << temp.topValue().time_pushed;
       m_clean_stack.push(temp.pop());
       if (temp.length()) {
-        std::cout << ",";
+        m_out << ",";
       }
     }
   }
@@ -59,12 +67,12 @@ public:
     auto a = new int[x];
 
     for (int i = 0; i < x; i++) {
-      std::cin >> a[i];
+      m_in >> a[i];
     }
 
     int k, t, s;
     while (true) {
-      std::cin >> k >> t >> s;
+      m_in >> k >> t >> s;
       if (k == 0) {
         break;
       }
@@ -87,19 +95,19 @@ public:
       cleanDish();
     }
     // when the last dish was cleaned all dishes are cleaned
-    std::cout << m_clean_stack.topValue().time_pushed << std::endl;
+    m_out << m_clean_stack.topValue().time_pushed << '\n';
     printCleanDishes();
-    std::cout << std::endl;
+    m_out << '\n';
 
-    std::cout << "NY"[full_course_eaters.length() == n] << std::endl;
+    m_out << "NY"[full_course_eaters.length() == n] << '\n';
 
     while (full_course_eaters.length()) {
-      std::cout << full_course_eaters.pop();
+      m_out << full_course_eaters.pop();
       if (full_course_eaters.length()) {
-        std::cout << ',';
+        m_out << ',';
       }
     }
-    std::cout << std::endl;
+    m_out << '\n';
 
     delete[] a;
   }
@@ -108,29 +116,46 @@ public:
 int main(int argc, char **argv) {
   auto list_type = selectStackImplementation(argc, argv);
   if (list_type.has_value()) {
+    cse204::FastReader in(std::cin);
+    cse204::FastWriter out(std::cout);
     // input n and x here, as they are required for array construction
     int n, x;
-    std::cin >> n >> x;
+    in >> n >> x;
     switch (list_type.value()) {
     case StackImplementationType::ARRAY_STACK:
       DishwasherSimulator(cse204::ArrayStack<Dish>(),
-                          cse204::ArrayStack<Dish>(), n, x)
+                          cse204::ArrayStack<Dish>(), n, x, in, out)
           .simulate();
       break;
     case StackImplementationType::LINKED_STACK:
       DishwasherSimulator(cse204::LinkedStack<Dish>(),
-                          cse204::LinkedStack<Dish>(), n, x)
+                          cse204::LinkedStack<Dish>(), n, x, in, out)
+          .simulate();
+      break;
+    case StackImplementationType::SEGMENTED_STACK:
+      DishwasherSimulator(cse204::SegmentedStack<Dish>(),
+                          cse204::SegmentedStack<Dish>(), n, x, in, out)
           .simulate();
       break;
     case StackImplementationType::ARRAY2STACK: {
       int max_dishes = n * x;
       auto *array = new Dish[max_dishes];
       DishwasherSimulator(cse204::ArrayStack<Dish>(max_dishes, array, 1),
-                          cse204::ArrayStack<Dish>(max_dishes, array, -1), n, x)
+                          cse204::ArrayStack<Dish>(max_dishes, array, -1), n, x,
+                          in, out)
           .simulate();
       delete[] array;
       break;
     }
+    case StackImplementationType::ARENA_STACK: {
+      // both stacks share one array that grows as needed, so n * x need not
+      // be reserved up front
+      cse204::MultiStackArena<Dish> arena(2);
+      DishwasherSimulator(cse204::ArenaStack<Dish>(arena, 0),
+                          cse204::ArenaStack<Dish>(arena, 1), n, x, in, out)
+          .simulate();
+      break;
+    }
     }
   }
 }
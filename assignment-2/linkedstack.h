@@ -2,54 +2,79 @@
 
 #include <algorithm>
 #include <cassert>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <utility>
 
 #include "stack.h"
 
 namespace cse204 {
 
-template <typename T> class LinkedStack : public Stack<T> {
+/* Stack stored as a chain of nodes, the top of the stack first. Nodes are
+ * obtained from Allocator.
+ *
+ * With Recycle set, popped nodes are kept on a free list and reused by later
+ * pushes instead of being returned to the allocator, so a stack whose length
+ * goes up and down within a range it has reached before does not allocate.
+ * The nodes are freed by shrink_to_fit and the destructor. */
+template <typename T, class Allocator = std::allocator<T>,
+          bool Recycle = false>
+class LinkedStack : public Stack<T> {
 
   using typename Stack<T>::size_t;
 
   struct node {
     T item;
     node *next;
-    /* Constructor to create sentinel node */
-    node(node *next) : item{}, next(next) {}
-    /* Constructor to create node with the item to contain */
-    node(const T &item, node *next = nullptr) : item(item), next(next) {}
-    node(T &&item, node *next = nullptr) : item(std::move(item)), next(next) {}
+    /* Constructor to create node with the item constructed from params */
+    template <class... R>
+    node(node *next, R &&...params)
+        : item(std::forward<R>(params)...), next(next) {}
   };
 
-  /* Sentinel node, to indicate the start of the list. First actual node is
-   * m_head->next. */
-  node *m_head;
+  /* Memory of a recycled node, linked through the storage of the node */
+  struct free_node {
+    free_node *next;
+  };
+
+  using allocator_type =
+      typename std::allocator_traits<Allocator>::template rebind_alloc<node>;
+  using allocator_traits =
+      typename std::allocator_traits<Allocator>::template rebind_traits<node>;
+
+  allocator_type m_allocator;
+
+  /* Top node, nullptr if stack is empty */
+  node *m_top;
+  /* Recycled nodes, always nullptr unless Recycle is set */
+  free_node *m_free;
 
   size_t m_length;
 
 public:
   /* Create empty list. */
-  LinkedStack() : m_head(new node(nullptr)), m_length(0) {}
+  LinkedStack() : m_top(nullptr), m_free(nullptr), m_length(0) {}
 
   /* Create list from initialiser list */
   LinkedStack(std::initializer_list<T> items) : LinkedStack() {
-    for (const T &item : items) {
-      push(item);
-    }
+    push_range(items.begin(), items.end());
   }
 
   /* Copy construct: copies elements from another list */
   LinkedStack(const LinkedStack &other) requires std::copyable<T>
-      : m_head(new node(nullptr)) {
-    static_assert(std::copyable<T>);
+      : LinkedStack() {
     copy_from(other);
   }
 
-  /* Move constructor: steals elements from another list */
+  /* Move constructor: steals elements and recycled nodes from another
+   * list */
   LinkedStack(LinkedStack &&other)
-      : m_head(other.m_head), m_length(other.m_length) {
+      : m_allocator(std::move(other.m_allocator)), m_top(other.m_top),
+        m_free(other.m_free), m_length(other.m_length) {
     /* Reset moved from linkedstack to initial empty list */
-    other.m_head = new node(nullptr);
+    other.m_top = nullptr;
+    other.m_free = nullptr;
     other.m_length = 0;
   }
 
@@ -59,25 +84,26 @@ public:
       // to handle self-assignment
       return *this;
     }
-    delete_elements();
+    clear();
     copy_from(other);
 
     return *this;
   }
 
-  /* Move assignment: steal elements from another list */
+  /* Move assignment: steal elements and recycled nodes from another list */
   LinkedStack &operator=(LinkedStack &&other) {
     if (this == &other) {
       // to handle self-assignment
       return *this;
     }
-    // delete current elements and steal everything from other list
-    delete_elements();
-    // swap the head sentinel nodes as well
-    std::swap(m_head, other.m_head);
+    // delete current elements and steal everything from other list, swapping
+    // the allocators along with the nodes (recycled ones too) they own
+    clear();
+    std::swap(m_allocator, other.m_allocator);
+    std::swap(m_top, other.m_top);
+    std::swap(m_free, other.m_free);
     m_length = other.m_length;
     // reset other list
-    other.m_head->next = nullptr;
     other.m_length = 0;
 
     return *this;
@@ -85,97 +111,185 @@ public:
 
   /* Destructor */
   ~LinkedStack() {
-    delete_elements();
-    delete m_head;
+    delete_chain(m_top);
+    shrink_to_fit();
   }
 
 private:
   /* helper methods */
 
-  /* delete all the nodes in the list, except the head */
-  void delete_elements() {
-    node *p = m_head->next;
-    while (p) {
-      node *t = p;
-      p = p->next;
-      delete t;
+  /* Creates a node from params, reusing a recycled one if there is one */
+  template <class... R> node *create_node(node *next, R &&...params) {
+    node *n;
+    if (Recycle && m_free) {
+      n = reinterpret_cast<node *>(m_free);
+      m_free = m_free->next;
+    } else {
+      n = allocator_traits::allocate(m_allocator, 1);
+    }
+    try {
+      allocator_traits::construct(m_allocator, n, next,
+                                  std::forward<R>(params)...);
+    } catch (...) {
+      free_memory(n);
+      throw;
     }
+    return n;
   }
 
-  /* Assuming the stack is cleared and do not have dangling resources, copy
-   * elements from other list */
-  void copy_from(const LinkedStack<T> &other) {
-    m_length = other.m_length;
-    // assume the other list may be empty at this point
-    m_head->next = nullptr;
+  /* Destroys the element of a node and frees or recycles the node */
+  void delete_node(node *n) {
+    allocator_traits::destroy(m_allocator, n);
+    free_memory(n);
+  }
 
-    if (m_length == 0) {
-      return;
+  /* Frees or recycles the memory of a node that is not constructed */
+  void free_memory(node *n) {
+    if constexpr (Recycle) {
+      m_free = ::new (static_cast<void *>(n)) free_node{m_free};
+    } else {
+      allocator_traits::deallocate(m_allocator, n, 1);
     }
+  }
 
-    node *old_node = other.m_head;
-    node *new_node = m_head;
+  /* delete a chain of nodes ending with nullptr */
+  void delete_chain(node *p) {
+    while (p) {
+      node *t = p;
+      p = p->next;
+      delete_node(t);
+    }
+  }
 
-    while (old_node->next) {
-      // new_node is the counterpart of old_node at this point
-      old_node = old_node->next;
-      new_node->next = new node(old_node->item);
-      new_node = new_node->next;
+  /* Assuming the stack is empty, copy elements from other list */
+  void copy_from(const LinkedStack &other) {
+    node **link = &m_top;
+    for (node *p = other.m_top; p; p = p->next) {
+      *link = create_node(nullptr, p->item);
+      link = &(*link)->next;
+      // count as we go, so a throwing copy leaves a consistent stack
+      m_length++;
     }
   }
 
 public:
+  /* Returns the recycled nodes to the allocator. */
+  void shrink_to_fit() {
+    while (m_free) {
+      node *n = reinterpret_cast<node *>(m_free);
+      m_free = m_free->next;
+      allocator_traits::deallocate(m_allocator, n, 1);
+    }
+  }
+
   /* Stack interface implementation. */
 
   /* Clear contents from the list, making it empty */
   void clear() override {
-    delete_elements();
-    // reset everything
-    m_head->next = nullptr;
-    // reset size
+    delete_chain(m_top);
+    m_top = nullptr;
     m_length = 0;
   }
 
   /* Pushes item on the top of the stack */
   void push(const T &item) override {
     if constexpr (std::copyable<T>) {
-      node *new_node = new node(item, m_head->next);
-      assert(m_head);
-      m_head->next = new_node;
-      m_length++;
+      emplace(item);
     }
   }
 
   /* Pushes item on the top of the stack */
-  void push(T &&item) override {
-    node *new_node = new node(std::move(item), m_head->next);
-    assert(m_head);
-    m_head->next = new_node;
-    m_length++;
-  }
+  void push(T &&item) override { emplace(std::move(item)); }
 
   /* Pops item from the top of the stack and returns value */
   T pop() override {
     if (m_length == 0) {
       throw std::runtime_error("Attempt to pop from empty stack");
     }
-    assert(m_head->next);
-    node *next = m_head->next;
+    assert(m_top);
+    node *top = m_top;
     /* move object if move constructor is available */
-    T ret = [next]() constexpr {
+    T ret = [top]() constexpr {
       if constexpr (std::move_constructible<T>) {
-        return std::move(next->item);
+        return std::move(top->item);
       } else {
-        return next->item;
+        return top->item;
       }
     }
     ();
-    m_head->next = next->next;
-    delete next;
+    m_top = top->next;
+    delete_node(top);
     m_length--;
     return ret;
   }
 
+  /* Constructs an element on the top of the stack from params */
+  template <class... R>
+  requires std::constructible_from<T, R...>
+  void emplace(R &&...params) {
+    m_top = create_node(m_top, std::forward<R>(params)...);
+    m_length++;
+  }
+
+  /* Pushes the elements of [first, last) in order, so the last one ends up on
+   * top. The nodes are linked into a chain of their own first, which is then
+   * spliced onto the top, so the stack is left unchanged if an element fails
+   * to construct. */
+  template <std::input_iterator I>
+  requires std::constructible_from<T, std::iter_reference_t<I>>
+  void push_range(I first, I last) {
+    node *top = nullptr;
+    node *bottom = nullptr;
+    size_t count = 0;
+    try {
+      for (; first != last; ++first, count++) {
+        top = create_node(top, *first);
+        if (!bottom) {
+          bottom = top;
+        }
+      }
+    } catch (...) {
+      delete_chain(top);
+      throw;
+    }
+    if (bottom) {
+      bottom->next = m_top;
+      m_top = top;
+      m_length += count;
+    }
+  }
+
+  /* Removes the top count elements without returning them. They are
+   * unlinked at once and deleted afterwards. */
+  void pop(size_t count) {
+    if (count < 0 || count > m_length) {
+      throw std::runtime_error("Attempt to pop more elements than in stack");
+    }
+    if (count == 0) {
+      return;
+    }
+    node *top = m_top;
+    node *bottom = top;
+    for (size_t i = 1; i < count; i++) {
+      bottom = bottom->next;
+    }
+    m_top = bottom->next;
+    m_length -= count;
+    bottom->next = nullptr;
+    delete_chain(top);
+  }
+
+  /* Moves every element to out, from the top down, leaving the stack empty.
+   * Returns the output iterator past the last element written. */
+  template <std::output_iterator<T &&> O> O pop_into(O out) {
+    for (node *p = m_top; p; p = p->next) {
+      *out = std::move(p->item);
+      ++out;
+    }
+    clear();
+    return out;
+  }
+
   /* Returns size of the stack */
   inline size_t length() const override { return m_length; }
 
@@ -184,17 +298,27 @@ public:
     if (m_length == 0) {
       throw std::runtime_error("Attempt to get top value from empty stack");
     }
-    assert(m_head->next);
-    return m_head->next->item;
+    assert(m_top);
+    return m_top->item;
   }
 
   /* Returns the value of the top element of the stack */
-  inline const T &topValue() const override { return topValue(); }
+  inline const T &topValue() const override {
+    if (m_length == 0) {
+      throw std::runtime_error("Attempt to get top value from empty stack");
+    }
+    assert(m_top);
+    return m_top->item;
+  }
 
   /* Has no effect */
   void setDirection(int) override {}
 };
 
+/* Linked stack that recycles its nodes */
+template <typename T, class Allocator = std::allocator<T>>
+using PooledLinkedStack = LinkedStack<T, Allocator, true>;
+
 #ifndef CSE204_STACK_OUTPUT_STREAM_IMPLEMENTED
 #define CSE204_STACK_OUTPUT_STREAM_IMPLEMENTED
 template <typename T>
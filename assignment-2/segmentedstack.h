@@ -0,0 +1,316 @@
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <concepts>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+
+#include "stack.h"
+
+namespace cse204 {
+
+/* Stack stored in a chain of fixed size blocks. A full block is never grown
+ * or copied, the next push starts a new block instead, so push and pop are
+ * O(1) even in the worst case and elements never move.
+ *
+ * The last block to become empty is kept as a spare instead of being freed,
+ * so pushing and popping back and forth across a block boundary does not
+ * allocate every time. */
+template <typename T, std::size_t BlockSize = 256>
+class SegmentedStack : public Stack<T> {
+  static_assert(BlockSize > 0, "Blocks must hold at least one element");
+
+  using typename Stack<T>::size_t;
+
+  struct block {
+    /* block below this one, nullptr for the bottom block */
+    block *prev;
+    /* only the elements below the top of the stack are constructed */
+    union {
+      T items[BlockSize];
+    };
+
+    block(block *prev) : prev(prev) {}
+    ~block() {}
+  };
+
+  /* block holding the top of the stack, nullptr if stack is empty */
+  block *m_top;
+  /* number of elements in the top block */
+  std::size_t m_top_count;
+  /* empty block kept for the next push that needs one */
+  block *m_spare;
+
+  size_t m_length;
+
+public:
+  /* Create empty stack. */
+  SegmentedStack()
+      : m_top(nullptr), m_top_count(0), m_spare(nullptr), m_length(0) {}
+
+  /* Create stack from initialiser list */
+  SegmentedStack(std::initializer_list<T> items) : SegmentedStack() {
+    for (const T &item : items) {
+      push(item);
+    }
+  }
+
+  /* Copy constructor: copies elements from another stack */
+  SegmentedStack(const SegmentedStack &other) requires std::copyable<T>
+      : SegmentedStack() {
+    copy_from(other);
+  }
+
+  /* Move constructor: steals elements from another stack */
+  SegmentedStack(SegmentedStack &&other)
+      : m_top(other.m_top), m_top_count(other.m_top_count),
+        m_spare(other.m_spare), m_length(other.m_length) {
+    other.m_top = other.m_spare = nullptr;
+    other.m_top_count = 0;
+    other.m_length = 0;
+  }
+
+  /* Copy assignment: copies elements from another stack */
+  SegmentedStack &operator=(const SegmentedStack &other)
+    requires std::copyable<T>
+  {
+    if (this == &other) {
+      return *this;
+    }
+    clear();
+    copy_from(other);
+    return *this;
+  }
+
+  /* Move assignment: steals elements from another stack */
+  SegmentedStack &operator=(SegmentedStack &&other) {
+    if (this == &other) {
+      return *this;
+    }
+    clear();
+    std::swap(m_top, other.m_top);
+    std::swap(m_top_count, other.m_top_count);
+    std::swap(m_spare, other.m_spare);
+    std::swap(m_length, other.m_length);
+    return *this;
+  }
+
+  /* Destructor */
+  ~SegmentedStack() {
+    clear();
+    delete m_spare;
+  }
+
+private:
+  /* helper methods */
+
+  /* Makes a new, empty block the top block, reusing the spare if there is
+   * one */
+  void push_block() {
+    block *b = m_spare ? m_spare : new block(nullptr);
+    m_spare = nullptr;
+    b->prev = m_top;
+    m_top = b;
+    m_top_count = 0;
+  }
+
+  /* Removes the empty top block, keeping it as the spare */
+  void pop_block() {
+    assert(m_top && m_top_count == 0);
+    block *empty = m_top;
+    m_top = empty->prev;
+    m_top_count = m_top ? BlockSize : 0;
+    delete m_spare;
+    m_spare = empty;
+  }
+
+  /* Assuming the stack is empty, copies the blocks of other stack from the
+   * top down */
+  void copy_from(const SegmentedStack &other) {
+    block **link = &m_top;
+    std::size_t count = other.m_top_count;
+    for (block *b = other.m_top; b; b = b->prev, count = BlockSize) {
+      *link = new block(nullptr);
+      std::uninitialized_copy_n(b->items, count, (*link)->items);
+      link = &(*link)->prev;
+    }
+    m_top_count = other.m_top_count;
+    m_length = other.m_length;
+  }
+
+public:
+  /* Stack interface implementation. */
+
+  /* Clear contents from the stack, making it empty. Keeps one block as the
+   * spare. */
+  void clear() override {
+    while (m_top) {
+      std::destroy_n(m_top->items, m_top_count);
+      m_top_count = 0;
+      pop_block();
+    }
+    m_length = 0;
+  }
+
+  /* Pushes item on the top of the stack */
+  void push(const T &item) override {
+    if constexpr (std::copyable<T>) {
+      if (!m_top || m_top_count == BlockSize) {
+        push_block();
+      }
+      std::construct_at(m_top->items + m_top_count, item);
+      m_top_count++;
+      m_length++;
+    }
+  }
+
+  /* Pushes item on the top of the stack */
+  void push(T &&item) override {
+    if (!m_top || m_top_count == BlockSize) {
+      push_block();
+    }
+    std::construct_at(m_top->items + m_top_count, std::move(item));
+    m_top_count++;
+    m_length++;
+  }
+
+  /* Pops item from the top of the stack and returns value */
+  T pop() override {
+    if (m_length == 0) {
+      throw std::runtime_error("Attempt to pop from empty stack");
+    }
+    T *top = m_top->items + m_top_count - 1;
+    /* move object if move constructor is available */
+    T ret = [top]() constexpr {
+      if constexpr (std::move_constructible<T>) {
+        return std::move(*top);
+      } else {
+        return *top;
+      }
+    }
+    ();
+    std::destroy_at(top);
+    m_top_count--;
+    m_length--;
+    if (m_top_count == 0) {
+      pop_block();
+    }
+    return ret;
+  }
+
+  /* Constructs an element on the top of the stack from params. Elements
+   * never move, so params may refer to one of them. */
+  template <class... R>
+  requires std::constructible_from<T, R...>
+  void emplace(R &&...params) {
+    if (!m_top || m_top_count == BlockSize) {
+      push_block();
+    }
+    std::construct_at(m_top->items + m_top_count, std::forward<R>(params)...);
+    m_top_count++;
+    m_length++;
+  }
+
+  /* Pushes the elements of [first, last) in order, so the last one ends up on
+   * top. Fills a block at a time with a single uninitialised copy if the
+   * size of the range is known. */
+  template <std::input_iterator I>
+  requires std::constructible_from<T, std::iter_reference_t<I>>
+  void push_range(I first, I last) {
+    if constexpr (!std::forward_iterator<I>) {
+      for (; first != last; ++first) {
+        emplace(*first);
+      }
+    } else {
+      std::size_t count = std::distance(first, last);
+      while (count > 0) {
+        if (!m_top || m_top_count == BlockSize) {
+          push_block();
+        }
+        std::size_t n = std::min(count, BlockSize - m_top_count);
+        std::uninitialized_copy_n(first, n, m_top->items + m_top_count);
+        std::advance(first, n);
+        m_top_count += n;
+        m_length += n;
+        count -= n;
+      }
+    }
+  }
+
+  /* Removes the top count elements without returning them */
+  void pop(size_t count) {
+    if (count < 0 || count > m_length) {
+      throw std::runtime_error("Attempt to pop more elements than in stack");
+    }
+    m_length -= count;
+    while (count > 0) {
+      std::size_t n = std::min<std::size_t>(count, m_top_count);
+      std::destroy_n(m_top->items + m_top_count - n, n);
+      m_top_count -= n;
+      count -= n;
+      if (m_top_count == 0) {
+        pop_block();
+      }
+    }
+  }
+
+  /* Moves every element to out, from the top down, leaving the stack empty.
+   * Returns the output iterator past the last element written. */
+  template <std::output_iterator<T &&> O> O pop_into(O out) {
+    std::size_t count = m_top_count;
+    for (block *b = m_top; b; b = b->prev, count = BlockSize) {
+      out = std::move(std::make_reverse_iterator(b->items + count),
+                      std::make_reverse_iterator(b->items), out);
+    }
+    clear();
+    return out;
+  }
+
+  /* Returns size of the stack */
+  inline size_t length() const override { return m_length; }
+
+  /* Returns the value of the top element of the stack */
+  inline T &topValue() override {
+    if (m_length == 0) {
+      throw std::runtime_error("Attempt to get top value from empty stack");
+    }
+    return m_top->items[m_top_count - 1];
+  }
+
+  /* Returns the value of the top element of the stack */
+  inline const T &topValue() const override {
+    if (m_length == 0) {
+      throw std::runtime_error("Attempt to get top value from empty stack");
+    }
+    return m_top->items[m_top_count - 1];
+  }
+
+  /* Has no effect */
+  void setDirection(int) override {}
+};
+
+#ifndef CSE204_STACK_OUTPUT_STREAM_IMPLEMENTED
+#define CSE204_STACK_OUTPUT_STREAM_IMPLEMENTED
+template <typename T>
+std::ostream &operator<<(std::ostream &os, Stack<T> &stack) {
+  SegmentedStack<T> temp;
+  while (stack.length() > 0) {
+    temp.push(std::move(stack.pop()));
+  }
+  os << '<';
+  while (temp.length() > 0) {
+    T v = temp.pop();
+    os << v;
+    if (temp.length() > 0) {
+      os << ", ";
+    }
+    stack.push(std::move(v));
+  }
+  os << '>';
+  return os;
+}
+#endif
+
+} // namespace cse204
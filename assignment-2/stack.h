@@ -14,6 +14,8 @@ protected:
   typedef long long size_t;
 
 public:
+  using value_type = T;
+
   /* List ADT methods */
   virtual void clear() = 0;
   virtual void push(const T &item) = 0;
@@ -25,6 +27,17 @@ public:
   virtual void setDirection(int direction) = 0;
 };
 
+/* Stack that also provides the bulk operations. Templates cannot be
+ * virtual, so they are part of the concrete stack types instead of the
+ * Stack interface. */
+template <class S, class T = typename S::value_type>
+concept BulkStack = std::derived_from<S, Stack<T>> &&
+                    requires(S stack, T *items, long long count) {
+  stack.push_range(items, items + count);
+  stack.pop(count);
+  { stack.pop_into(items) } -> std::same_as<T *>;
+};
+
 template <typename T>
 std::ostream &operator<<(std::ostream &os, Stack<T> &stack);
 
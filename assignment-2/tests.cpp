@@ -1,8 +1,24 @@
+#include <atomic>
 #include <catch2/catch.hpp>
+#include <iterator>
+#include <map>
+#include <mutex>
+#include <sstream>
 #include <stdexcept>
+#include <thread>
+#include <type_traits>
 
+#include "arenastack.h"
 #include "arraystack.h"
+#include "concurrentstack.h"
 #include "linkedstack.h"
+#include "segmentedstack.h"
+
+/* Catch2 only takes templates with type parameters, small blocks make the
+ * tests cross block boundaries */
+template <class T> using SegmentedStack = cse204::SegmentedStack<T, 4>;
+template <class T> using LinkedStack = cse204::LinkedStack<T>;
+template <class T> using PooledLinkedStack = cse204::PooledLinkedStack<T>;
 
 std::ostream &operator<<(std::ostream &os, const std::vector<int> &vec) {
   os << '<';
@@ -16,8 +32,12 @@ std::ostream &operator<<(std::ostream &os, const std::vector<int> &vec) {
   return os;
 }
 
-TEMPLATE_PRODUCT_TEST_CASE("Basic tests", "[ArrayStack][LinkedStack]",
-                           (cse204::ArrayStack, cse204::LinkedStack), (int)) {
+TEMPLATE_PRODUCT_TEST_CASE("Basic tests",
+                           "[ArrayStack][LinkedStack][SegmentedStack]"
+                           "[ArenaStack]",
+                           (cse204::ArrayStack, LinkedStack, PooledLinkedStack,
+                            SegmentedStack, cse204::ArenaStack),
+                           (int)) {
   TestType stack = {20, 23, 12, 15};
 
   SECTION("Clear method should empty stack") {
@@ -52,8 +72,11 @@ TEMPLATE_PRODUCT_TEST_CASE("Basic tests", "[ArrayStack][LinkedStack]",
   }
 }
 
-TEMPLATE_PRODUCT_TEST_CASE("Bulk tests", "[ArrayStack][LinkedStack]",
-                           (cse204::ArrayStack, cse204::LinkedStack),
+TEMPLATE_PRODUCT_TEST_CASE("Bulk tests",
+                           "[ArrayStack][LinkedStack][SegmentedStack]"
+                           "[ArenaStack]",
+                           (cse204::ArrayStack, LinkedStack, PooledLinkedStack,
+                            SegmentedStack, cse204::ArenaStack),
                            (std::string)) {
   TestType stack;
 
@@ -282,12 +305,34 @@ TEST_CASE("Stack should work correctly with non-owning memory",
     }
   }
 
+  SECTION("Copy assignment should keep the direction of the target") {
+    // two stacks growing towards each other, as in the dishwasher
+    cse204::ArrayStack<std::string> down(100, data, -1);
+    cse204::ArrayStack<std::string> up = {"a", "b", "c"};
+    stack.push("x");
+    down = up;
+    CHECK(data[97] == "c");
+    CHECK(data[99] == "a");
+    CHECK(stack.topValue() == "x");
+
+    cse204::ArrayStack<std::string> other;
+    other = down;
+    CHECK(cse204::to_string(other) == "<a, b, c>");
+    for (auto item : {"c", "b", "a"}) {
+      CHECK(down.pop() == item);
+      CHECK(other.pop() == item);
+    }
+  }
+
   delete[] data;
 }
 
 // test no memory is leaked
-TEMPLATE_PRODUCT_TEST_CASE("Non-trivial elements", "[ArrayStack][LinkedStack]",
-                           (cse204::ArrayStack, cse204::LinkedStack),
+TEMPLATE_PRODUCT_TEST_CASE("Non-trivial elements",
+                           "[ArrayStack][LinkedStack][SegmentedStack]"
+                           "[ArenaStack]",
+                           (cse204::ArrayStack, LinkedStack, PooledLinkedStack,
+                            SegmentedStack, cse204::ArenaStack),
                            (std::vector<int>)) {
   TestType stack;
   std::vector<std::vector<int>> vec, vec2;
@@ -344,8 +389,11 @@ TEMPLATE_PRODUCT_TEST_CASE("Non-trivial elements", "[ArrayStack][LinkedStack]",
 }
 
 // Test move-only type
-TEMPLATE_PRODUCT_TEST_CASE("Move-only type", "[ArrayStack][LinkedStack]",
-                           (cse204::ArrayStack, cse204::LinkedStack),
+TEMPLATE_PRODUCT_TEST_CASE("Move-only type",
+                           "[ArrayStack][LinkedStack][SegmentedStack]"
+                           "[ArenaStack]",
+                           (cse204::ArrayStack, LinkedStack, PooledLinkedStack,
+                            SegmentedStack, cse204::ArenaStack),
                            (std::unique_ptr<int>)) {
   TestType stack;
   SECTION("Push/Pop") {
@@ -376,3 +424,444 @@ TEMPLATE_PRODUCT_TEST_CASE("Move-only type", "[ArrayStack][LinkedStack]",
     }
   }
 }
+
+static_assert(cse204::BulkStack<cse204::ArrayStack<int>>);
+static_assert(cse204::BulkStack<cse204::LinkedStack<int>>);
+static_assert(cse204::BulkStack<cse204::PooledLinkedStack<int>>);
+static_assert(cse204::BulkStack<cse204::SegmentedStack<int>>);
+static_assert(cse204::BulkStack<cse204::ArenaStack<int>>);
+
+TEMPLATE_PRODUCT_TEST_CASE("Bulk operations",
+                           "[ArrayStack][LinkedStack][SegmentedStack]"
+                           "[ArenaStack]",
+                           (cse204::ArrayStack, LinkedStack, PooledLinkedStack,
+                            SegmentedStack, cse204::ArenaStack),
+                           (std::string)) {
+  TestType stack = {"a", "b"};
+  std::vector<std::string> items = {"c", "d", "e", "f", "g", "h"};
+
+  SECTION("Emplace should construct element on top") {
+    stack.emplace(3, 'x');
+    CHECK(stack.topValue() == "xxx");
+    stack.emplace();
+    CHECK(stack.length() == 4);
+    CHECK(cse204::to_string(stack) == "<a, b, xxx, >");
+  }
+
+  SECTION("Push range should push elements in order") {
+    stack.push_range(items.begin(), items.end());
+    CHECK(stack.length() == 8);
+    CHECK(stack.topValue() == "h");
+    CHECK(cse204::to_string(stack) == "<a, b, c, d, e, f, g, h>");
+
+    std::istringstream in("i j");
+    stack.push_range(std::istream_iterator<std::string>(in),
+                     std::istream_iterator<std::string>());
+    CHECK(stack.length() == 10);
+    CHECK(stack.pop() == "j");
+  }
+
+  SECTION("Pop with count should discard elements from the top") {
+    stack.push_range(items.begin(), items.end());
+    stack.pop(5);
+    CHECK(cse204::to_string(stack) == "<a, b, c>");
+    stack.pop(0);
+    CHECK(stack.length() == 3);
+    CHECK_THROWS_AS(stack.pop(4), std::runtime_error);
+    stack.pop(3);
+    CHECK(stack.length() == 0);
+    stack.push("z");
+    CHECK(cse204::to_string(stack) == "<z>");
+  }
+
+  SECTION("Pop into should drain the stack from the top down") {
+    stack.push_range(items.begin(), items.end());
+    std::vector<std::string> out;
+    stack.pop_into(std::back_inserter(out));
+    CHECK(stack.length() == 0);
+    CHECK(out == std::vector<std::string>{"h", "g", "f", "e", "d", "c", "b",
+                                          "a"});
+
+    std::string array[2];
+    stack.push_range(items.begin(), items.begin() + 2);
+    CHECK(stack.pop_into(array) == array + 2);
+    CHECK(array[0] == "d");
+    CHECK(array[1] == "c");
+  }
+
+  SECTION("Bulk operations should work in reverse direction") {
+    stack.clear();
+    stack.setDirection(-1);
+    stack.push_range(items.begin(), items.end());
+    CHECK(cse204::to_string(stack) == "<c, d, e, f, g, h>");
+    TestType copy = stack;
+    copy.emplace("i");
+    CHECK(cse204::to_string(copy) == "<c, d, e, f, g, h, i>");
+    stack.pop(2);
+    std::vector<std::string> out;
+    stack.pop_into(std::back_inserter(out));
+    CHECK(out == std::vector<std::string>{"f", "e", "d", "c"});
+  }
+}
+
+TEST_CASE("Bulk operations on move-only elements",
+          "[ArrayStack][LinkedStack][SegmentedStack]") {
+  std::vector<std::unique_ptr<int>> items;
+  for (int i = 0; i < 10; i++) {
+    items.push_back(std::make_unique<int>(i));
+  }
+  SegmentedStack<std::unique_ptr<int>> stack;
+  stack.push_range(std::make_move_iterator(items.begin()),
+                   std::make_move_iterator(items.end()));
+  stack.emplace(new int(10));
+
+  cse204::PooledLinkedStack<std::unique_ptr<int>> linked;
+  std::vector<std::unique_ptr<int>> out;
+  stack.pop_into(std::back_inserter(out));
+  linked.push_range(std::make_move_iterator(out.begin()),
+                    std::make_move_iterator(out.end()));
+  out.clear();
+
+  cse204::ArrayStack<std::unique_ptr<int>> array;
+  linked.pop_into(std::back_inserter(out));
+  array.push_range(std::make_move_iterator(out.begin()),
+                   std::make_move_iterator(out.end()));
+  for (int i = 10; i >= 0; i--) {
+    REQUIRE(*array.pop() == i);
+  }
+}
+
+/* Allocator counting the calls made to it through any of its rebinds */
+struct AllocationCounts {
+  inline static int allocations = 0;
+  inline static int deallocations = 0;
+};
+
+template <class T> struct CountingAllocator : std::allocator<T> {
+  template <class U> struct rebind {
+    using other = CountingAllocator<U>;
+  };
+
+  CountingAllocator() = default;
+  template <class U> CountingAllocator(const CountingAllocator<U> &) {}
+
+  T *allocate(std::size_t n) {
+    AllocationCounts::allocations++;
+    return std::allocator<T>::allocate(n);
+  }
+
+  void deallocate(T *p, std::size_t n) {
+    AllocationCounts::deallocations++;
+    std::allocator<T>::deallocate(p, n);
+  }
+};
+
+using CountedLinkedStack =
+    cse204::LinkedStack<std::string, CountingAllocator<std::string>>;
+using CountedPooledLinkedStack =
+    cse204::PooledLinkedStack<std::string, CountingAllocator<std::string>>;
+
+TEMPLATE_TEST_CASE("Linked stack allocations", "[LinkedStack]",
+                   CountedLinkedStack, CountedPooledLinkedStack) {
+  constexpr bool recycles = std::is_same_v<TestType, CountedPooledLinkedStack>;
+  AllocationCounts::allocations = AllocationCounts::deallocations = 0;
+
+  SECTION("Empty stacks should not allocate") {
+    TestType stack;
+    TestType moved = std::move(stack);
+    stack = std::move(moved);
+    CHECK(AllocationCounts::allocations == 0);
+  }
+
+  SECTION("Each node should be allocated once when recycling") {
+    {
+      TestType stack;
+      for (int i = 0; i < 100; i++) {
+        stack.push(std::to_string(i));
+      }
+      CHECK(AllocationCounts::allocations == 100);
+
+      std::vector<std::string> items(50, "x");
+      for (int round = 0; round < 10; round++) {
+        stack.pop(51);
+        stack.push_range(items.begin(), items.end());
+        stack.emplace("y");
+        stack.pop();
+      }
+      stack.clear();
+      for (int i = 0; i < 100; i++) {
+        stack.push(std::to_string(i));
+      }
+      CHECK(stack.topValue() == "99");
+      CHECK(stack.length() == 100);
+      if (recycles) {
+        CHECK(AllocationCounts::allocations == 100);
+        CHECK(AllocationCounts::deallocations == 0);
+        stack.pop(40);
+        stack.shrink_to_fit();
+        CHECK(AllocationCounts::deallocations == 40);
+      } else {
+        CHECK(AllocationCounts::allocations == 100 + 10 * 51 + 100);
+      }
+    }
+    CHECK(AllocationCounts::deallocations == AllocationCounts::allocations);
+  }
+}
+
+/* Allocator that is only equal to its copies, it records which one
+ * allocated each block so a block freed by another one can be detected */
+template <class T> struct OwnerAllocator {
+  using value_type = T;
+  inline static std::map<void *, int> owners;
+  inline static int next_owner = 0;
+
+  int owner;
+
+  OwnerAllocator() : owner(next_owner++) {}
+  template <class U>
+  OwnerAllocator(const OwnerAllocator<U> &other) : owner(other.owner) {}
+
+  T *allocate(std::size_t n) {
+    T *p = std::allocator<T>().allocate(n);
+    owners[p] = owner;
+    return p;
+  }
+
+  void deallocate(T *p, std::size_t n) {
+    CHECK(owners[p] == owner);
+    owners.erase(p);
+    std::allocator<T>().deallocate(p, n);
+  }
+
+  template <class U> bool operator==(const OwnerAllocator<U> &other) const {
+    return owner == other.owner;
+  }
+};
+
+TEMPLATE_TEST_CASE(
+    "Linked stack move assignment", "[LinkedStack]",
+    (cse204::LinkedStack<std::string, OwnerAllocator<std::string>>),
+    (cse204::PooledLinkedStack<std::string, OwnerAllocator<std::string>>)) {
+  using allocator = OwnerAllocator<std::string>;
+
+  SECTION("Nodes should be freed by the allocator that created them") {
+    {
+      TestType first;
+      TestType second;
+      // every stack has an allocator of its own, fill both with nodes and
+      // recycled nodes
+      for (int i = 0; i < 10; i++) {
+        first.push(std::to_string(i));
+        second.push(std::to_string(i + 10));
+      }
+      first.pop(3);
+      second.pop(5);
+      TestType other;
+      other.push("x");
+      second = std::move(first);
+      first = std::move(other);
+      CHECK(second.length() == 7);
+      CHECK(second.topValue() == "6");
+      CHECK(first.length() == 1);
+      second.push("y");
+      first.push("z");
+    }
+    CHECK(allocator::owners.empty());
+  }
+}
+
+TEST_CASE("Segmented stack block boundaries", "[SegmentedStack]") {
+  SegmentedStack<std::string> stack;
+
+  SECTION("Pushing and popping around a boundary should keep elements") {
+    for (int i = 0; i < 4; i++) {
+      stack.push(std::to_string(i));
+    }
+    for (int round = 0; round < 10; round++) {
+      stack.push("top");
+      stack.push("above");
+      CHECK(stack.pop() == "above");
+      CHECK(stack.pop() == "top");
+      CHECK(stack.topValue() == "3");
+    }
+    CHECK(cse204::to_string(stack) == "<0, 1, 2, 3>");
+  }
+
+  SECTION("Copies should keep a partially filled top block") {
+    for (int i = 0; i < 10; i++) {
+      stack.push(std::to_string(i));
+    }
+    SegmentedStack<std::string> copy = stack;
+    CHECK(copy.length() == 10);
+    copy.push("10");
+    CHECK(cse204::to_string(copy) == "<0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10>");
+    CHECK(cse204::to_string(stack) == "<0, 1, 2, 3, 4, 5, 6, 7, 8, 9>");
+  }
+
+  SECTION("Cleared stack should be reusable") {
+    for (int i = 0; i < 10; i++) {
+      stack.push(std::to_string(i));
+    }
+    stack.clear();
+    CHECK(stack.length() == 0);
+    CHECK_THROWS_AS(stack.pop(), std::runtime_error);
+    stack.push("a");
+    CHECK(cse204::to_string(stack) == "<a>");
+  }
+}
+
+TEST_CASE("Stacks sharing an arena", "[ArenaStack]") {
+  cse204::MultiStackArena<std::string> arena(4, 8);
+  std::vector<cse204::ArenaStack<std::string>> stacks;
+  for (int i = 0; i < 4; i++) {
+    stacks.emplace_back(arena, i);
+  }
+
+  SECTION("Stacks should keep their elements when regions are rebalanced") {
+    // stacks grow at different rates, so regions move both ways
+    for (int i = 0; i < 50; i++) {
+      for (int s = 0; s < 4; s++) {
+        if (i % (s + 1) == 0) {
+          stacks[s].push(std::to_string(s) + ":" + std::to_string(i));
+        }
+      }
+      if (i % 7 == 6) {
+        stacks[0].pop(3);
+      }
+    }
+    CHECK(stacks[0].length() == 29);
+    CHECK(stacks[1].length() == 25);
+    CHECK(arena.capacity() >= 29 + 25 + 17 + 13);
+    for (int s = 1; s < 4; s++) {
+      for (int i = 49 - 49 % (s + 1); i >= 0; i -= s + 1) {
+        REQUIRE(stacks[s].pop() ==
+                std::to_string(s) + ":" + std::to_string(i));
+      }
+      CHECK(stacks[s].length() == 0);
+    }
+  }
+
+  SECTION("Filling the arena from a single stack should grow it") {
+    for (int i = 0; i < 100; i++) {
+      stacks[2].emplace(std::to_string(i));
+      stacks[3].push(stacks[2].topValue());
+    }
+    CHECK(arena.capacity() >= 200);
+    CHECK(stacks[0].length() == 0);
+    CHECK(stacks[3].length() == 100);
+    std::vector<std::string> out;
+    stacks[2].pop_into(std::back_inserter(out));
+    CHECK(out.front() == "99");
+    CHECK(out.back() == "0");
+    stacks[0].push("a");
+    CHECK(cse204::to_string(stacks[0]) == "<a>");
+  }
+
+  SECTION("Copies and assignments between stacks should keep elements") {
+    stacks[0] = {"a", "b", "c"};
+    cse204::ArenaStack<std::string> copy = stacks[0];
+    copy.push("d");
+    stacks[1] = copy;
+    stacks[2] = std::move(copy);
+    CHECK(copy.length() == 0);
+    CHECK(cse204::to_string(stacks[0]) == "<a, b, c>");
+    CHECK(cse204::to_string(stacks[1]) == "<a, b, c, d>");
+    CHECK(cse204::to_string(stacks[2]) == "<a, b, c, d>");
+
+    cse204::ArenaStack<std::string> moved = std::move(stacks[1]);
+    CHECK(moved.pop() == "d");
+    CHECK(arena.length(1) == 3);
+    CHECK(stacks[1].length() == 0);
+  }
+
+  SECTION("Assignments within the arena should survive rebalancing") {
+    cse204::MultiStackArena<std::string> small(2, 4);
+    cse204::ArenaStack<std::string> a(small, 0), b(small, 1);
+    b = {"x", "y", "z"};
+    a = b;
+    CHECK(cse204::to_string(a) == "<x, y, z>");
+    CHECK(cse204::to_string(b) == "<x, y, z>");
+    b.push("w");
+    a = std::move(b);
+    CHECK(cse204::to_string(a) == "<x, y, z, w>");
+    CHECK(b.length() == 0);
+    b = a;
+    b = std::move(a);
+    CHECK(cse204::to_string(b) == "<x, y, z, w>");
+    CHECK(a.length() == 0);
+  }
+
+  SECTION("Invalid stacks should not be created") {
+    CHECK_THROWS_AS(cse204::ArenaStack<std::string>(arena, 4),
+                    std::runtime_error);
+    CHECK_THROWS_AS(cse204::MultiStackArena<int>(0), std::runtime_error);
+  }
+}
+
+TEST_CASE("Concurrent stack", "[ConcurrentStack]") {
+  SECTION("Elements should be popped in reverse order from a single thread") {
+    cse204::ConcurrentStack<std::string> stack;
+    CHECK(stack.empty());
+    CHECK_FALSE(stack.try_pop().has_value());
+    for (int i = 0; i < 1000; i++) {
+      stack.push(std::to_string(i));
+    }
+    CHECK_FALSE(stack.empty());
+    for (int i = 999; i >= 500; i--) {
+      REQUIRE(stack.try_pop() == std::to_string(i));
+    }
+    // popped nodes are reused
+    stack.emplace(3, 'x');
+    CHECK(stack.try_pop() == "xxx");
+    CHECK(stack.try_pop() == "499");
+    stack.clear();
+    CHECK(stack.empty());
+    CHECK_FALSE(stack.try_pop().has_value());
+  }
+
+  SECTION("Move-only elements should be moved in and out") {
+    cse204::ConcurrentStack<std::unique_ptr<int>> stack;
+    for (int i = 0; i < 100; i++) {
+      stack.push(std::make_unique<int>(i));
+    }
+    for (int i = 99; i >= 0; i--) {
+      REQUIRE(**stack.try_pop() == i);
+    }
+  }
+
+  SECTION("Concurrent pushes and pops should pop every element once") {
+    constexpr int threads = 4, per_thread = 20000;
+    cse204::ConcurrentStack<int> stack;
+    std::vector<int> count(threads * per_thread, 0);
+    std::atomic<int> popped = 0;
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; t++) {
+      workers.emplace_back([&stack, t]() {
+        for (int i = 0; i < per_thread; i++) {
+          stack.push(t * per_thread + i);
+        }
+      });
+      // poppers merge their counts under a lock once everything is popped
+      workers.emplace_back([&stack, &count, &popped]() {
+        std::vector<int> local;
+        while (popped.load() < threads * per_thread) {
+          if (auto value = stack.try_pop()) {
+            local.push_back(*value);
+            popped++;
+          }
+        }
+        static std::mutex mutex;
+        std::lock_guard lock(mutex);
+        for (int value : local) {
+          count[value]++;
+        }
+      });
+    }
+    for (auto &worker : workers) {
+      worker.join();
+    }
+    CHECK(stack.empty());
+    CHECK(std::all_of(count.begin(), count.end(),
+                      [](int c) { return c == 1; }));
+  }
+}
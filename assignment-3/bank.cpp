@@ -1,5 +1,6 @@
 #include "arrayqueue.h"
 #include "console_helper.h"
+#include "fast_io.h"
 #include "linkedqueue.h"
 
 #include <iomanip>
@@ -47,32 +48,36 @@ class Bank {
   queue_t queues[2];
   Booth booths[2];
 
+  cse204::FastReader &m_in;
+  cse204::FastWriter &m_out;
+
 public:
-  Bank() {}
+  Bank(cse204::FastReader &in, cse204::FastWriter &out)
+      : m_in(in), m_out(out) {}
 
   void serveCustomer() {}
 
   void switchQueues() {
     if ((queues[0].length() + 1) < queues[1].length()) {
-      std::cout << "qs" << std::endl;
+      m_out << "qs" << '\n';
       queues[0].enqueue(queues[1].leaveQueue());
     } else if ((queues[1].length() + 1) < queues[0].length()) {
       queues[1].enqueue(queues[0].leaveQueue());
-      std::cout << "qs" << std::endl;
+      m_out << "qs" << '\n';
     }
   }
   void printState() {
     if (g_debug_print) {
-      std::cout << time << " ";
-      std::cout << queues[0] << " " << queues[1] << " ";
+      m_out << time << " ";
+      m_out << queues[0] << " " << queues[1] << " ";
       if (booths[0].is_busy(time)) {
-        std::cout << booths[0].customer;
+        m_out << booths[0].customer;
       }
-      std::cout << " ";
+      m_out << " ";
       if (booths[1].is_busy(time)) {
-        std::cout << booths[1].customer;
+        m_out << booths[1].customer;
       }
-      std::cout << std::endl;
+      m_out << '\n';
     }
   }
   // run simulation assuming no new customers have come
@@ -107,11 +112,11 @@ public:
 
   void process() {
     int n;
-    std::cin >> n;
+    m_in >> n;
 
     int t, s;
     while (n--) {
-      std::cin >> t >> s;
+      m_in >> t >> s;
       elapse(t);
       Customer c{t, s};
       // if either booth is empty serve directly
@@ -134,10 +139,8 @@ public:
       printState();
     }
     elapse(std::numeric_limits<int>::max());
-    std::cout << "Booth 1 finishes service at t=" << booths[0].busy_until
-              << std::endl;
-    std::cout << "Booth 2 finishes service at t=" << booths[1].busy_until
-              << std::endl;
+    m_out << "Booth 1 finishes service at t=" << booths[0].busy_until << '\n';
+    m_out << "Booth 2 finishes service at t=" << booths[1].busy_until << '\n';
   }
 };
 
@@ -145,13 +148,15 @@ int main(int argc, char **argv) {
   g_debug_print = argc >= 3 && std::strcmp(argv[2], "-D") == 0;
   auto queue_type = selectQueueImplementation(argc, argv);
   if (queue_type.has_value()) {
+    cse204::FastReader in(std::cin);
+    cse204::FastWriter out(std::cout);
     // select queue
     switch (queue_type.value()) {
     case QueueImplementationType::LINKED_QUEUE:
-      Bank<cse204::LinkedQueue>().process();
+      Bank<cse204::LinkedQueue>(in, out).process();
       break;
     case QueueImplementationType::ARRAY_QUEUE:
-      Bank<cse204::ArrayQueue>().process();
+      Bank<cse204::ArrayQueue>(in, out).process();
       break;
     }
   }
@@ -2,13 +2,16 @@
 #include <iostream>
 
 #include "bstree.h"
+#include "fast_io.h"
 
 int main(int argc, char **argv) {
   std::string path = "../test_input.txt";
   if (argc >= 2) {
     path = argv[1];
   }
-  std::ifstream in(path);
+  std::ifstream file(path);
+  cse204::FastReader in(file);
+  cse204::FastWriter out(std::cout);
 
   char cmd;
   std::string param;
@@ -18,35 +21,35 @@ int main(int argc, char **argv) {
   while (in >> cmd >> param) {
     if (cmd == 'T') {
       if (param == "In") {
-        tree.foreach ([](int k) { std::cout << k << ' '; },
+        tree.foreach ([&](int k) { out << k << ' '; },
                       cse204::TraversalOrder::IN_ORDER);
-        std::cout << std::endl;
+        out << '\n';
       } else if (param == "Pre") {
-        tree.foreach ([](int k) { std::cout << k << ' '; },
+        tree.foreach ([&](int k) { out << k << ' '; },
                       cse204::TraversalOrder::PRE_ORDER);
-        std::cout << std::endl;
+        out << '\n';
       } else if (param == "Post") {
-        tree.foreach ([](int k) { std::cout << k << ' '; },
+        tree.foreach ([&](int k) { out << k << ' '; },
                       cse204::TraversalOrder::POST_ORDER);
-        std::cout << std::endl;
+        out << '\n';
       }
     } else {
       int b = std::stoi(param);
       switch (cmd) {
       case 'I':
         tree.insert(b);
-        std::cout << tree << std::endl;
+        out << tree << '\n';
         break;
       case 'D':
         try {
           tree.remove(b);
-          std::cout << tree << std::endl;
+          out << tree << '\n';
         } catch (std::runtime_error& e) {
-          std::cout << "Invalid Operation" << std::endl;
+          out << "Invalid Operation" << '\n';
         }
         break;
       case 'F':
-        std::cout << (tree.find(b) ? "True" : "False") << std::endl;
+        out << (tree.find(b) ? "True" : "False") << '\n';
         break;
       }
     }
@@ -0,0 +1,128 @@
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <random>
+
+#include "fast_io.h"
+
+const char *k_input_path = "io_benchmark_input.txt";
+const char *k_output_path = "io_benchmark_output.txt";
+
+// return time required to perform task in milliseconds
+float benchmark(auto &&task, int n = 3) {
+  double duration = 0.0;
+  int t = n;
+  while (t--) {
+    auto start = std::chrono::high_resolution_clock::now();
+    task();
+    duration +=
+        (std::chrono::high_resolution_clock::now() - start).count() / 1e6;
+  }
+  return duration / n;
+}
+
+template <class... R, class T>
+void print_comma_seperated(std::ostream &os, T &&a, R &&...rest) {
+  os << a;
+  if constexpr (sizeof...(rest)) {
+    os << ',';
+    print_comma_seperated(os, rest...);
+  } else {
+    os << std::endl;
+  }
+}
+
+// writes n random integers, one per line
+void generate_input(int n) {
+  std::mt19937 eng(204);
+  std::uniform_int_distribution<int> value(-1000000000, 1000000000);
+  std::ofstream file(k_input_path);
+  cse204::FastWriter out(file);
+  for (int i = 0; i < n; i++) {
+    out << value(eng) << '\n';
+  }
+}
+
+// time of reading every integer of the input file
+template <class reader_type> float read_time() {
+  volatile long long sink;
+  return benchmark([&]() {
+    std::ifstream file(k_input_path);
+    reader_type in(file);
+    long long sum = 0;
+    int v;
+    while (in >> v) {
+      sum += v;
+    }
+    sink = sum;
+  });
+}
+
+// time of writing n integers to a file, ending each line with end_line
+template <class writer_type> float write_time(int n, auto &&end_line) {
+  return benchmark([&]() {
+    std::ofstream file(k_output_path);
+    writer_type out(file);
+    for (int i = 0; i < n; i++) {
+      out << i;
+      end_line(out);
+    }
+  });
+}
+
+// the console drivers read with std::cin and wrote with std::endl
+struct StreamReader {
+  std::istream &in;
+  StreamReader(std::istream &in) : in(in) {}
+  StreamReader &operator>>(int &v) {
+    in >> v;
+    return *this;
+  }
+  explicit operator bool() const { return bool(in); }
+};
+
+struct StreamWriter {
+  std::ostream &out;
+  StreamWriter(std::ostream &out) : out(out) {}
+  template <class T> StreamWriter &operator<<(T &&v) {
+    out << v;
+    return *this;
+  }
+};
+
+void benchmark_io(std::ostream &out) {
+  int N[] = {100000, 1000000, 10000000};
+  print_comma_seperated(out, ' ', ' ', ' ', "Time required in ms");
+  print_comma_seperated(out, 'n', "istream Read", "FastReader Read",
+                        "ostream Write with endl", "ostream Write with \\n",
+                        "FastWriter Write");
+
+  auto endl = [](StreamWriter &w) { w.out << std::endl; };
+  auto newline = [](auto &w) { w << '\n'; };
+
+  for (int n : N) {
+    generate_input(n);
+    float stream_read = read_time<StreamReader>();
+    float fast_read = read_time<cse204::FastReader>();
+    float stream_newline = write_time<StreamWriter>(n, newline);
+    float fast_write = write_time<cse204::FastWriter>(n, newline);
+    // a flush per line takes too long for the largest input
+    if (n <= 1000000) {
+      print_comma_seperated(out, n, stream_read, fast_read,
+                            write_time<StreamWriter>(n, endl), stream_newline,
+                            fast_write);
+    } else {
+      print_comma_seperated(out, n, stream_read, fast_read, ' ',
+                            stream_newline, fast_write);
+    }
+  }
+  std::remove(k_input_path);
+  std::remove(k_output_path);
+}
+
+int main() {
+  std::ofstream io_file("io.csv");
+  benchmark_io(io_file);
+  return 0;
+}
@@ -8,32 +8,35 @@
 #include <stack>
 #include <vector>
 
+#include "fast_io.h"
 #include "utils.h"
 
 constexpr int inf = std::numeric_limits<int>::max();
 
 int main(int argc, char **argv) {
   configure_io(argc, argv);
+  cse204::FastReader in(std::cin);
+  cse204::FastWriter out(std::cout);
   int t;
-  std::cin >> t;
+  in >> t;
   while (t--) {
     int n_board, n_dice, n_ladder, n_snake;
 
-    std::cin >> n_dice >> n_board;
+    in >> n_dice >> n_board;
 
     std::vector<int> jumps(n_board + 1, 0);
 
-    std::cin >> n_ladder;
+    in >> n_ladder;
     for (int i = 0; i < n_ladder; i++) {
       int from, to;
-      std::cin >> from >> to;
+      in >> from >> to;
       jumps[from] = to;
     }
 
-    std::cin >> n_snake;
+    in >> n_snake;
     for (int i = 0; i < n_snake; i++) {
       int from, to;
-      std::cin >> from >> to;
+      in >> from >> to;
       jumps[from] = to;
     }
 
@@ -77,7 +80,7 @@ int main(int argc, char **argv) {
 
     if (squares[n_board].n_shortest_path < inf) {
 
-      std::cout << squares[n_board].n_shortest_path << std::endl;
+      out << squares[n_board].n_shortest_path << '\n';
       std::stack<int> shortest_path;
 
       shortest_path.push(n_board);
@@ -87,17 +90,17 @@ int main(int argc, char **argv) {
       }
 
       while (!shortest_path.empty()) {
-        std::cout << shortest_path.top();
+        out << shortest_path.top();
         shortest_path.pop();
         if (!shortest_path.empty()) {
-          std::cout << " -> ";
+          out << " -> ";
         }
       }
-      std::cout << std::endl;
+      out << '\n';
 
     } else {
-      std::cout << -1 << std::endl;
-      std::cout << "No solution" << std::endl;
+      out << -1 << '\n';
+      out << "No solution" << '\n';
     }
 
     bool allreachable = true;
@@ -106,16 +109,16 @@ int main(int argc, char **argv) {
         if (allreachable) {
           allreachable = false;
         }
-        std::cout << i << ' ';
+        out << i << ' ';
       }
     }
 
     if (allreachable) {
-      std::cout << "All reachable" << std::endl;
+      out << "All reachable" << '\n';
     } else {
-      std::cout << std::endl;
+      out << '\n';
     }
 
-    std::cout << std::endl;
+    out << '\n';
   }
 }
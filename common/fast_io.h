@@ -0,0 +1,207 @@
+#pragma once
+
+#include <charconv>
+#include <concepts>
+#include <cstddef>
+#include <cstring>
+#include <istream>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+namespace cse204 {
+
+/* Reads whitespace separated tokens out of the buffer of an input stream,
+ * a block at a time, with integers parsed by hand. Like an istream, a failed
+ * read puts the reader in a failed state that converts to false.
+ *
+ * The buffer of the stream is looked up on every refill, so redirecting the
+ * stream with rdbuf keeps working. Reading from the stream directly while a
+ * reader is in use skips whatever the reader has buffered. */
+class FastReader {
+  static constexpr std::size_t k_buffer_size = 1 << 16;
+
+  std::istream &m_stream;
+  char m_buffer[k_buffer_size];
+  std::size_t m_begin = 0;
+  std::size_t m_end = 0;
+  bool m_fail = false;
+
+  bool refill() {
+    m_begin = 0;
+    m_end = m_stream.rdbuf()->sgetn(m_buffer, k_buffer_size);
+    return m_end > 0;
+  }
+
+  /* Returns whether there are characters left, refilling if necessary */
+  inline bool available() { return m_begin < m_end || refill(); }
+
+  static inline bool is_space(char c) {
+    return c == ' ' || c == '\n' || c == '\t' || c == '\r' || c == '\v' ||
+           c == '\f';
+  }
+
+  static inline bool is_digit(char c) { return c >= '0' && c <= '9'; }
+
+  /* Skips whitespace, returns false and fails at the end of input */
+  bool start_token() {
+    if (m_fail) {
+      return false;
+    }
+    while (available()) {
+      if (!is_space(m_buffer[m_begin])) {
+        return true;
+      }
+      m_begin++;
+    }
+    m_fail = true;
+    return false;
+  }
+
+public:
+  explicit FastReader(std::istream &stream) : m_stream(stream) {}
+
+  FastReader(const FastReader &) = delete;
+  FastReader &operator=(const FastReader &) = delete;
+
+  explicit operator bool() const { return !m_fail; }
+
+  /* Reads an integer in decimal, which must fit in T */
+  template <std::integral T>
+  requires(!std::same_as<T, bool> && !std::same_as<T, char>)
+  FastReader &operator>>(T &value) {
+    if (!start_token()) {
+      return *this;
+    }
+    bool negative = false;
+    if (m_buffer[m_begin] == '-' || m_buffer[m_begin] == '+') {
+      negative = m_buffer[m_begin] == '-';
+      m_begin++;
+    }
+    if (!available() || !is_digit(m_buffer[m_begin])) {
+      m_fail = true;
+      return *this;
+    }
+    // accumulated with the sign of the result, so the minimum value fits
+    T result = 0;
+    while (available() && is_digit(m_buffer[m_begin])) {
+      T digit = m_buffer[m_begin++] - '0';
+      result = result * 10 + (negative ? -digit : digit);
+    }
+    value = result;
+    return *this;
+  }
+
+  /* Reads the next character that is not whitespace */
+  FastReader &operator>>(char &c) {
+    if (start_token()) {
+      c = m_buffer[m_begin++];
+    }
+    return *this;
+  }
+
+  /* Reads a token up to the next whitespace */
+  FastReader &operator>>(std::string &s) {
+    if (!start_token()) {
+      return *this;
+    }
+    s.clear();
+    while (available()) {
+      std::size_t end = m_begin;
+      while (end < m_end && !is_space(m_buffer[end])) {
+        end++;
+      }
+      s.append(m_buffer + m_begin, end - m_begin);
+      m_begin = end;
+      if (end < m_end) {
+        break;
+      }
+    }
+    return *this;
+  }
+};
+
+/* Collects output in a buffer and hands it to the buffer of an output stream
+ * only when full, on flush() and on destruction. Write '\n' instead of
+ * std::endl, which would flush every line. Types without a fast path are
+ * written through the stream after flushing, so the order of the output is
+ * kept. */
+class FastWriter {
+  static constexpr std::size_t k_buffer_size = 1 << 16;
+
+  std::ostream &m_stream;
+  char m_buffer[k_buffer_size];
+  std::size_t m_size = 0;
+
+  void write(const char *s, std::size_t n) {
+    if (n > k_buffer_size - m_size) {
+      flush_buffer();
+      if (n > k_buffer_size) {
+        m_stream.rdbuf()->sputn(s, n);
+        return;
+      }
+    }
+    std::memcpy(m_buffer + m_size, s, n);
+    m_size += n;
+  }
+
+  void flush_buffer() {
+    if (m_size > 0) {
+      m_stream.rdbuf()->sputn(m_buffer, m_size);
+      m_size = 0;
+    }
+  }
+
+public:
+  explicit FastWriter(std::ostream &stream) : m_stream(stream) {}
+
+  FastWriter(const FastWriter &) = delete;
+  FastWriter &operator=(const FastWriter &) = delete;
+
+  ~FastWriter() { flush(); }
+
+  /* Writes out everything buffered so far */
+  void flush() {
+    flush_buffer();
+    m_stream.flush();
+  }
+
+  FastWriter &operator<<(char c) {
+    if (m_size == k_buffer_size) {
+      flush_buffer();
+    }
+    m_buffer[m_size++] = c;
+    return *this;
+  }
+
+  FastWriter &operator<<(std::string_view s) {
+    write(s.data(), s.size());
+    return *this;
+  }
+
+  template <std::integral T>
+  requires(!std::same_as<T, bool>)
+  FastWriter &operator<<(T value) {
+    // enough for any 64 bit integer with its sign
+    char digits[24];
+    auto result = std::to_chars(digits, digits + sizeof(digits), value);
+    write(digits, result.ptr - digits);
+    return *this;
+  }
+
+  /* Anything else an ostream can write */
+  template <class T>
+  requires(!std::integral<std::remove_cvref_t<T>> &&
+           !std::convertible_to<T, std::string_view> &&
+           requires(std::ostream &os, T &&value) {
+             os << std::forward<T>(value);
+           })
+  FastWriter &operator<<(T &&value) {
+    flush_buffer();
+    m_stream << std::forward<T>(value);
+    return *this;
+  }
+};
+
+} // namespace cse204